@@ -21,6 +21,8 @@ AAmmo::AAmmo()
 	AmmoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AmmoCollisionSphere"));
 	AmmoCollisionSphere->SetupAttachment(GetRootComponent());
 	AmmoCollisionSphere->SetSphereRadius(50.f);
+	AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	AmmoCollisionSphere->SetGenerateOverlapEvents(false);
 }
 
 void AAmmo::Tick(float DeltaTime)
@@ -31,8 +33,6 @@ void AAmmo::Tick(float DeltaTime)
 void AAmmo::BeginPlay()
 {
     Super::BeginPlay();
-
-	AmmoCollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AAmmo::AmmoSphereOverlap);
 }
 
 void AAmmo::SetItemProperties(EItemState State)
@@ -72,21 +72,27 @@ void AAmmo::SetItemProperties(EItemState State)
 		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 			break;
+		case EItemState::EIS_PickedUp:
+		//Collected ammo waits hidden in the pickup pool
+		AmmoMesh->SetSimulatePhysics(false);
+		AmmoMesh->SetEnableGravity(false);
+		AmmoMesh->SetVisibility(false);
+		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			break;
 
 	}
 }
 
-void AAmmo::AmmoSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+float AAmmo::GetAutoPickupRadius() const
 {
-	if (OtherActor)
-	{
-		auto OverlappedCharacter = Cast<AFrameCharacter>(OtherActor);
-		if (OverlappedCharacter)
-		{
-			StartItemCurve(OverlappedCharacter);
-			AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		}
-	}
+	return AmmoCollisionSphere->GetScaledSphereRadius();
+}
+
+UStaticMesh* AAmmo::GetGroundLootMesh() const
+{
+	UStaticMesh* GroundLootMesh = Super::GetGroundLootMesh();
+	return GroundLootMesh ? GroundLootMesh : AmmoMesh->GetStaticMesh();
 }
 
 void AAmmo::EnableCustomDepth()
@@ -27,14 +27,8 @@ protected:
 	//Override of SetItemProperties in order to set AmmoMesh properties
 	virtual void SetItemProperties(EItemState State) override;
 
-	//Called when overlapping area sphere
-	UFUNCTION()
-	void AmmoSphereOverlap(UPrimitiveComponent* OverlappedComponent, 
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp, 
-		int32 OtherBodyIndex, 
-		bool bFromSweep, 
-		const FHitResult& SweepResult);
+	//Characters walking inside AmmoCollisionSphere collect the ammo
+	virtual float GetAutoPickupRadius() const override;
 
 	
 
@@ -53,7 +47,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ammo, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* AmmoIconTexture;
 
-	//Overlap sphere for picking up ammo
+	//Radius for picking up ammo by walking over it
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo, meta = (AllowPrivateAccess = "true"))
 	class USphereComponent* AmmoCollisionSphere;
 
@@ -63,6 +57,9 @@ public:
 
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
 	
+	//Falls back to the ammo box mesh
+	virtual UStaticMesh* GetGroundLootMesh() const override;
+
 	virtual void EnableCustomDepth() override;
 	virtual void DisableCustomDepth() override;
 };
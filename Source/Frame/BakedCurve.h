@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
+#include "Curves/CurveVector.h"
+
+namespace BakedCurve
+{
+	FORCEINLINE float SampleCurve(const UCurveFloat* Curve, float Time) { return Curve->GetFloatValue(Time); }
+	FORCEINLINE FVector SampleCurve(const UCurveVector* Curve, float Time) { return Curve->GetVectorValue(Time); }
+}
+
+/**
+ * Curve asset sampled at even steps over its time range into a flat table.
+ * Eval is a clamp and a lerp between two neighbouring samples, times outside the
+ * range hold the end values like the curve's default constant extrapolation.
+ */
+template<typename ValueType>
+struct TBakedCurve
+{
+	template<typename CurveType>
+	void Bake(const CurveType* Curve, int32 Resolution)
+	{
+		check(Curve);
+		Curve->GetTimeRange(MinTime, MaxTime);
+
+		const int32 NumSamples{ FMath::Max(Resolution, 2) };
+		const float Duration{ MaxTime - MinTime };
+		SamplesPerSecond = Duration > KINDA_SMALL_NUMBER ? (NumSamples - 1) / Duration : 0.f;
+
+		Samples.SetNumUninitialized(NumSamples);
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			Samples[i] = BakedCurve::SampleCurve(Curve, MinTime + Duration * i / (NumSamples - 1));
+		}
+	}
+
+	ValueType Eval(float Time) const
+	{
+		checkSlow(Samples.Num() >= 2);
+		const int32 LastIndex{ Samples.Num() - 1 };
+		const float Position{ FMath::Clamp((Time - MinTime) * SamplesPerSecond, 0.f, static_cast<float>(LastIndex)) };
+		const int32 Index{ FMath::Min(static_cast<int32>(Position), LastIndex - 1) };
+		return FMath::Lerp(Samples[Index], Samples[Index + 1], Position - Index);
+	}
+
+	float MinTime = 0.f;
+	float MaxTime = 0.f;
+	float SamplesPerSecond = 0.f;
+
+	TArray<ValueType> Samples;
+};
+
+using FBakedFloatCurve = TBakedCurve<float>;
+using FBakedVectorCurve = TBakedCurve<FVector>;
@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CorpseSettings.h"
+
+UCorpseSettings::UCorpseSettings() :
+	MaxCorpses(24),
+	TimeBudgetMs(0.25f)
+{
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "CorpseSettings.generated.h"
+
+/**
+ * Cap and frame budget for the corpse subsystem, editable under Project Settings > Game > Corpses
+ * and saved to DefaultGame.ini.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Corpses"))
+class FRAME_API UCorpseSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UCorpseSettings();
+
+	virtual FName GetCategoryName() const override { return FName("Game"); }
+
+	//Corpse actors kept before the oldest are converted to static instances
+	UPROPERTY(Config, EditAnywhere, Category = Corpses, meta = (ClampMin = "0"))
+	int32 MaxCorpses;
+
+	//Milliseconds per frame spent converting and recycling
+	UPROPERTY(Config, EditAnywhere, Category = Corpses, meta = (ClampMin = "0.0"))
+	float TimeBudgetMs;
+};
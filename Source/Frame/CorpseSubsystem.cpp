@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CorpseSubsystem.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/WidgetComponent.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Enemy.h"
+#include "EnemyPoolSubsystem.h"
+#include "CorpseSettings.h"
+#include "InstancedVisuals.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Corpses"), STAT_UpdateCorpses, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Corpse Actors"), STAT_CorpseActors, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Static Corpses"), STAT_StaticCorpses, STATGROUP_Frame);
+
+void UCorpseSubsystem::Deinitialize()
+{
+	InstancedVisuals::DestroyActor(VisualsActor);
+	Corpses.Empty();
+	StaticCorpses.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCorpseSubsystem::AddCorpse(AEnemy* Enemy, float Lifetime)
+{
+	if (!IsValid(Enemy)) return;
+
+	UWorld* World = Enemy->GetWorld();
+	UCorpseSubsystem* CorpseSubsystem = World ? World->GetSubsystem<UCorpseSubsystem>() : nullptr;
+	if (CorpseSubsystem)
+	{
+		CorpseSubsystem->AddCorpse(Enemy, Lifetime, World->GetTimeSeconds());
+		return;
+	}
+
+	FTimerHandle ReleaseTimer;
+	TWeakObjectPtr<AEnemy> WeakEnemy(Enemy);
+	Enemy->GetWorldTimerManager().SetTimer(ReleaseTimer, FTimerDelegate::CreateLambda([WeakEnemy]()
+	{
+		UEnemyPoolSubsystem::ReleaseEnemy(WeakEnemy.Get(), WeakEnemy.Get());
+	}), FMath::Max(Lifetime, KINDA_SMALL_NUMBER), false);
+}
+
+void UCorpseSubsystem::AddCorpse(AEnemy* Enemy, float Lifetime, float Now)
+{
+	FCorpse Corpse;
+	Corpse.Enemy = Enemy;
+	Corpse.ExpireTime = Now + Lifetime;
+	Corpses.Add(Corpse);
+}
+
+int32 UCorpseSubsystem::GetNumStaticCorpses() const
+{
+	int32 NumStatic{ 0 };
+	for (const TPair<UStaticMesh*, FStaticCorpseBucket>& Bucket : StaticCorpses)
+	{
+		NumStatic += Bucket.Value.ExpireTimes.Num();
+	}
+	return NumStatic;
+}
+
+void UCorpseSubsystem::Tick(float DeltaTime)
+{
+	if (Corpses.Num() == 0 && StaticCorpses.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_UpdateCorpses);
+
+	const UCorpseSettings* Settings{ GetDefault<UCorpseSettings>() };
+	const double StartTime{ FPlatformTime::Seconds() };
+	const double TimeBudgetMs{ Settings->TimeBudgetMs };
+	auto IsOverBudget = [StartTime, TimeBudgetMs]() { return (FPlatformTime::Seconds() - StartTime) * 1000.0 > TimeBudgetMs; };
+	const float Now{ GetWorld()->GetTimeSeconds() };
+
+	//Recycle expired corpse actors, forget any destroyed elsewhere
+	for (int32 i = 0; i < Corpses.Num() && !IsOverBudget();)
+	{
+		AEnemy* Enemy = Corpses[i].Enemy.Get();
+		if (Enemy && Now < Corpses[i].ExpireTime)
+		{
+			i++;
+			continue;
+		}
+
+		//Released enemies come back through the pool, so it must not still be a corpse of ours
+		Corpses.RemoveAt(i, 1, false);
+		if (Enemy && Enemy->IsDying())
+		{
+			UEnemyPoolSubsystem::ReleaseEnemy(this, Enemy);
+		}
+	}
+
+	//Over the cap, the oldest stop being actors
+	while (Corpses.Num() > Settings->MaxCorpses && !IsOverBudget())
+	{
+		const FCorpse Oldest = Corpses[0];
+		Corpses.RemoveAt(0, 1, false);
+		ConvertToStatic(Oldest);
+	}
+
+	//Expire static corpses, each removal swaps the last instance in
+	for (TPair<UStaticMesh*, FStaticCorpseBucket>& Bucket : StaticCorpses)
+	{
+		FStaticCorpseBucket& Statics = Bucket.Value;
+		for (int32 InstanceIndex = Statics.ExpireTimes.Num() - 1; InstanceIndex >= 0 && !IsOverBudget(); InstanceIndex--)
+		{
+			if (Now < Statics.ExpireTimes[InstanceIndex]) continue;
+
+			const int32 LastIndex{ Statics.ExpireTimes.Num() - 1 };
+			if (InstanceIndex != LastIndex)
+			{
+				FTransform LastTransform;
+				Statics.MeshComponent->GetInstanceTransform(LastIndex, LastTransform, true);
+				Statics.MeshComponent->UpdateInstanceTransform(InstanceIndex, LastTransform, true, false, true);
+			}
+			Statics.MeshComponent->RemoveInstance(LastIndex);
+			Statics.ExpireTimes.RemoveAtSwap(InstanceIndex, 1, false);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_CorpseActors, Corpses.Num());
+	SET_DWORD_STAT(STAT_StaticCorpses, GetNumStaticCorpses());
+}
+
+void UCorpseSubsystem::ConvertToStatic(const FCorpse& Corpse)
+{
+	AEnemy* Enemy = Corpse.Enemy.Get();
+	if (Enemy == nullptr || !Enemy->IsDying()) return;
+
+	UStaticMesh* CorpseMesh = Enemy->GetCorpseMesh();
+	if (CorpseMesh)
+	{
+		//Authored in the skeletal mesh's space, so it lies where the frozen pose was
+		UInstancedStaticMeshComponent* MeshComponent = GetStaticCorpseComponent(CorpseMesh);
+		MeshComponent->AddInstance(Enemy->GetMesh()->GetComponentTransform(), true);
+		StaticCorpses.FindChecked(CorpseMesh).ExpireTimes.Add(Corpse.ExpireTime);
+	}
+
+	UEnemyPoolSubsystem::ReleaseEnemy(this, Enemy);
+}
+
+UInstancedStaticMeshComponent* UCorpseSubsystem::GetStaticCorpseComponent(UStaticMesh* Mesh)
+{
+	FStaticCorpseBucket& Bucket = StaticCorpses.FindOrAdd(Mesh);
+	if (Bucket.MeshComponent) return Bucket.MeshComponent;
+
+	UInstancedStaticMeshComponent* MeshComponent = InstancedVisuals::AddMeshComponent(GetWorld(), VisualsActor, Mesh);
+
+	Bucket.MeshComponent = MeshComponent;
+	return MeshComponent;
+}
+
+TStatId UCorpseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCorpseSubsystem, STATGROUP_Tickables);
+}
+
+namespace CorpseStats
+{
+	//What a set of enemies still costs per frame
+	struct FEnemyCost
+	{
+		int32 Enemies = 0;
+		int32 TickingComponents = 0;
+		int32 CollidingComponents = 0;
+		int32 VisibleWidgets = 0;
+		int32 RunningBrains = 0;
+	};
+
+	void AddEnemyCost(const AEnemy* Enemy, FEnemyCost& Cost)
+	{
+		Cost.Enemies++;
+		TInlineComponentArray<UActorComponent*> Components(Enemy);
+		for (const UActorComponent* Component : Components)
+		{
+			if (Component->IsComponentTickEnabled())
+			{
+				Cost.TickingComponents++;
+			}
+			const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+			if (Primitive && Primitive->IsCollisionEnabled() && Enemy->GetActorEnableCollision())
+			{
+				Cost.CollidingComponents++;
+			}
+			const UWidgetComponent* Widget = Cast<UWidgetComponent>(Component);
+			if (Widget && Widget->IsVisible())
+			{
+				Cost.VisibleWidgets++;
+			}
+		}
+
+		const AAIController* AIController = Cast<AAIController>(Enemy->GetController());
+		const UBrainComponent* Brain = AIController ? AIController->GetBrainComponent() : nullptr;
+		if (Brain && Brain->IsRunning())
+		{
+			Cost.RunningBrains++;
+		}
+	}
+
+	//Logs live against corpse enemy cost
+	void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr) return;
+
+		FEnemyCost LiveCost;
+		FEnemyCost CorpseCost;
+		for (TActorIterator<AEnemy> It(World); It; ++It)
+		{
+			if (It->IsHidden()) continue; //Parked in the enemy pool
+			AddEnemyCost(*It, It->IsDying() ? CorpseCost : LiveCost);
+		}
+
+		const UCorpseSubsystem* CorpseSubsystem = World->GetSubsystem<UCorpseSubsystem>();
+		const int32 NumStatic{ CorpseSubsystem ? CorpseSubsystem->GetNumStaticCorpses() : 0 };
+
+		auto LogCost = [](const TCHAR* Label, const FEnemyCost& Cost)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s: %d enemies, %d ticking components, %d colliding components, %d visible widgets, %d running behavior trees"),
+				Label, Cost.Enemies, Cost.TickingComponents, Cost.CollidingComponents, Cost.VisibleWidgets, Cost.RunningBrains);
+		};
+		LogCost(TEXT("Live enemies"), LiveCost);
+		LogCost(TEXT("Corpse enemies"), CorpseCost);
+		UE_LOG(LogTemp, Log, TEXT("Static corpses: %d instances"), NumStatic);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CorpseStatsCommand(
+	TEXT("Frame.CorpseStats"),
+	TEXT("Logs ticking, colliding and AI cost of live enemies against corpses."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&CorpseStats::Run));
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CorpseSubsystem.generated.h"
+
+class AEnemy;
+class UInstancedStaticMeshComponent;
+
+//Enemy actor lying dead with its pose frozen
+struct FCorpse
+{
+	TWeakObjectPtr<AEnemy> Enemy;
+	float ExpireTime = 0.f;
+};
+
+//Static corpses sharing one mesh, instance i expires at ExpireTimes[i]
+USTRUCT()
+struct FStaticCorpseBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* MeshComponent = nullptr;
+
+	TArray<float> ExpireTimes;
+};
+
+/**
+ * Keeps dead enemies cheap. Corpses are stripped of collision, tick, AI and widgets when they die and
+ * frozen once the death animation ends. Past UCorpseSettings::MaxCorpses the oldest become an instance of the class's
+ * corpse mesh, or go straight back to the enemy pool if it has none, and expired corpses are recycled.
+ * Conversions and recycling run under the per-frame time budget from UCorpseSettings.
+ */
+UCLASS()
+class FRAME_API UCorpseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Hands a frozen corpse to the world's corpse subsystem, or releases it after Lifetime if there is none
+	static void AddCorpse(AEnemy* Enemy, float Lifetime);
+
+	void AddCorpse(AEnemy* Enemy, float Lifetime, float Now);
+
+	FORCEINLINE int32 GetNumCorpses() const { return Corpses.Num(); }
+	int32 GetNumStaticCorpses() const;
+
+private:
+
+	//Swaps the actor for an instance of its corpse mesh, or just recycles it
+	void ConvertToStatic(const FCorpse& Corpse);
+
+	UInstancedStaticMeshComponent* GetStaticCorpseComponent(UStaticMesh* Mesh);
+
+	//Oldest first
+	TArray<FCorpse> Corpses;
+
+	UPROPERTY()
+	TMap<UStaticMesh*, FStaticCorpseBucket> StaticCorpses;
+
+	//Actor holding the instanced mesh components
+	UPROPERTY()
+	AActor* VisualsActor = nullptr;
+};
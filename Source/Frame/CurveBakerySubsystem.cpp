@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CurveBakerySubsystem.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+namespace CurveBakery
+{
+	template<typename ValueType, typename CurveType>
+	TSharedPtr<const TBakedCurve<ValueType>> FindOrBake(TMap<FObjectKey, TSharedPtr<const TBakedCurve<ValueType>>>* Cache, const CurveType* Curve)
+	{
+		if (Curve == nullptr) return nullptr;
+
+		if (Cache)
+		{
+			if (const TSharedPtr<const TBakedCurve<ValueType>>* Cached = Cache->Find(Curve))
+			{
+				return *Cached;
+			}
+		}
+
+		TSharedRef<TBakedCurve<ValueType>> Baked = MakeShared<TBakedCurve<ValueType>>();
+		Baked->Bake(Curve, UCurveBakerySubsystem::BakeResolution);
+		if (Cache)
+		{
+			Cache->Add(Curve, Baked);
+		}
+		return Baked;
+	}
+
+	UCurveBakerySubsystem* GetBakery(const UObject* WorldContextObject)
+	{
+		const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		return GameInstance ? GameInstance->GetSubsystem<UCurveBakerySubsystem>() : nullptr;
+	}
+}
+
+void UCurveBakerySubsystem::Deinitialize()
+{
+	FloatCurves.Empty();
+	VectorCurves.Empty();
+
+	Super::Deinitialize();
+}
+
+TSharedPtr<const FBakedFloatCurve> UCurveBakerySubsystem::GetBakedCurve(const UObject* WorldContextObject, const UCurveFloat* Curve)
+{
+	UCurveBakerySubsystem* Bakery = CurveBakery::GetBakery(WorldContextObject);
+	return CurveBakery::FindOrBake<float>(Bakery ? &Bakery->FloatCurves : nullptr, Curve);
+}
+
+TSharedPtr<const FBakedVectorCurve> UCurveBakerySubsystem::GetBakedCurve(const UObject* WorldContextObject, const UCurveVector* Curve)
+{
+	UCurveBakerySubsystem* Bakery = CurveBakery::GetBakery(WorldContextObject);
+	return CurveBakery::FindOrBake<FVector>(Bakery ? &Bakery->VectorCurves : nullptr, Curve);
+}
+
+namespace CurveBakeryComparison
+{
+	constexpr int32 NumAccuracySamples{ 1000 };
+	constexpr int32 NumTimingEvals{ 100000 };
+
+	FORCEINLINE float GetError(float A, float B) { return FMath::Abs(A - B); }
+	FORCEINLINE float GetError(const FVector& A, const FVector& B) { return (A - B).GetAbsMax(); }
+
+	//Logs worst error and evaluation time of the baked table against the live curve
+	template<typename ValueType, typename CurveType>
+	void Compare(const CurveType* Curve, int32 Resolution)
+	{
+		TBakedCurve<ValueType> Baked;
+		Baked.Bake(Curve, Resolution);
+		const float Duration{ Baked.MaxTime - Baked.MinTime };
+
+		//Offset by half a step so samples fall between baked points as well as on them
+		float MaxError{ 0.f };
+		for (int32 i = 0; i < NumAccuracySamples; i++)
+		{
+			const float Time{ Baked.MinTime + Duration * (i + 0.5f) / NumAccuracySamples };
+			MaxError = FMath::Max(MaxError, GetError(BakedCurve::SampleCurve(Curve, Time), Baked.Eval(Time)));
+		}
+
+		//Sum results so the loops are not optimized away
+		ValueType Sink{ BakedCurve::SampleCurve(Curve, Baked.MinTime) };
+		const float TimeStep{ Duration / NumTimingEvals };
+
+		double StartTime{ FPlatformTime::Seconds() };
+		for (int32 i = 0; i < NumTimingEvals; i++)
+		{
+			Sink += BakedCurve::SampleCurve(Curve, Baked.MinTime + TimeStep * i);
+		}
+		const double LiveSeconds{ FPlatformTime::Seconds() - StartTime };
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumTimingEvals; i++)
+		{
+			Sink += Baked.Eval(Baked.MinTime + TimeStep * i);
+		}
+		const double BakedSeconds{ FPlatformTime::Seconds() - StartTime };
+
+		UE_LOG(LogTemp, Display, TEXT("%-40s max error %.6f, live %.3f ms, baked %.3f ms (%d evals, %d samples, checksum %f)"),
+			*Curve->GetName(), MaxError, LiveSeconds * 1000.0, BakedSeconds * 1000.0, NumTimingEvals, Resolution, GetError(Sink, Sink * 0.f));
+	}
+
+	void Run(const TArray<FString>& Args)
+	{
+		const int32 Resolution{ Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : UCurveBakerySubsystem::BakeResolution };
+
+		//Every loaded curve asset, which includes the ones referenced by items and weapons
+		for (TObjectIterator<UCurveFloat> It; It; ++It)
+		{
+			if (It->HasAnyFlags(RF_ClassDefaultObject)) continue;
+			Compare<float>(*It, Resolution);
+		}
+		for (TObjectIterator<UCurveVector> It; It; ++It)
+		{
+			if (It->HasAnyFlags(RF_ClassDefaultObject)) continue;
+			Compare<FVector>(*It, Resolution);
+		}
+	}
+}
+
+static FAutoConsoleCommand CompareBakedCurvesCommand(
+	TEXT("Frame.CompareBakedCurves"),
+	TEXT("Logs accuracy and evaluation time of baked curve tables against every loaded float and vector curve. Optional sample count."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&CurveBakeryComparison::Run));
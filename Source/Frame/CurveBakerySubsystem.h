@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "BakedCurve.h"
+#include "CurveBakerySubsystem.generated.h"
+
+/**
+ * Bakes curve assets used every frame (item interp, interp pulse, pistol slide) into lookup
+ * tables once per game instance. Items sharing a curve share one table.
+ */
+UCLASS()
+class FRAME_API UCurveBakerySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	//Baked table for curve, cached in the game instance's bakery or baked on the spot if there is none. Null for a null curve
+	static TSharedPtr<const FBakedFloatCurve> GetBakedCurve(const UObject* WorldContextObject, const UCurveFloat* Curve);
+	static TSharedPtr<const FBakedVectorCurve> GetBakedCurve(const UObject* WorldContextObject, const UCurveVector* Curve);
+
+	//Samples per baked table
+	static constexpr int32 BakeResolution{ 128 };
+
+private:
+
+	TMap<FObjectKey, TSharedPtr<const FBakedFloatCurve>> FloatCurves;
+	TMap<FObjectKey, TSharedPtr<const FBakedVectorCurve>> VectorCurves;
+};
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageQueueSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/DamageType.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Apply Queued Damage"), STAT_ApplyQueuedDamage, STATGROUP_Frame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Hits Queued"), STAT_DamageHitsQueued, STATGROUP_Frame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Victims"), STAT_DamageVictims, STATGROUP_Frame);
+
+void UDamageQueueSubsystem::QueueDamage(const UObject* WorldContextObject, AActor* Victim, float Damage, AController* InstigatorController, AActor* DamageCauser)
+{
+	if (Victim == nullptr || WorldContextObject == nullptr) return;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	UDamageQueueSubsystem* DamageQueue = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr;
+	if (DamageQueue)
+	{
+		DamageQueue->AddDamage(Victim, Damage, InstigatorController, DamageCauser);
+		return;
+	}
+	UGameplayStatics::ApplyDamage(Victim, Damage, InstigatorController, DamageCauser, UDamageType::StaticClass());
+}
+
+void UDamageQueueSubsystem::AddDamage(AActor* Victim, float Damage, AController* InstigatorController, AActor* DamageCauser)
+{
+	if (Victim == nullptr) return;
+
+	int32& VictimIndex = VictimIndices.FindOrAdd(Victim, INDEX_NONE);
+	if (VictimIndex == INDEX_NONE)
+	{
+		VictimIndex = PendingDamage.AddDefaulted();
+		PendingDamage[VictimIndex].Victim = Victim;
+	}
+
+	FQueuedDamage& Queued = PendingDamage[VictimIndex];
+	Queued.Damage += Damage;
+	Queued.InstigatorController = InstigatorController;
+	Queued.DamageCauser = DamageCauser;
+	Queued.NumHits++;
+}
+
+void UDamageQueueSubsystem::Tick(float DeltaTime)
+{
+	if (PendingDamage.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_ApplyQueuedDamage);
+	SET_DWORD_STAT(STAT_DamageVictims, PendingDamage.Num());
+
+	//Take the queue so damage dealt by reactions waits for the next flush
+	TArray<FQueuedDamage> Damages = MoveTemp(PendingDamage);
+	PendingDamage.Reset();
+	VictimIndices.Reset();
+
+	for (const FQueuedDamage& Queued : Damages)
+	{
+		INC_DWORD_STAT_BY(STAT_DamageHitsQueued, Queued.NumHits);
+		if (!IsValid(Queued.Victim)) continue;
+
+		UGameplayStatics::ApplyDamage(Queued.Victim, Queued.Damage, Queued.InstigatorController.Get(), Queued.DamageCauser.Get(), UDamageType::StaticClass());
+	}
+}
+
+TStatId UDamageQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageQueueSubsystem, STATGROUP_Tickables);
+}
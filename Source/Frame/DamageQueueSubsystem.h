@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageQueueSubsystem.generated.h"
+
+//Damage collected for one victim this frame
+USTRUCT()
+struct FQueuedDamage
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	AActor* Victim = nullptr;
+
+	//Sum of every hit queued this frame
+	UPROPERTY()
+	float Damage = 0.f;
+
+	//Instigator and causer of the latest hit, credited with the whole amount
+	TWeakObjectPtr<AController> InstigatorController;
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	int32 NumHits = 0;
+};
+
+/**
+ * Collects damage dealt during the frame and applies it once per victim, so a victim hit
+ * by several bullets or caught in several explosions runs TakeDamage and its reactions
+ * (aggro, stun roll, health bar, death) once with the combined amount.
+ */
+UCLASS()
+class FRAME_API UDamageQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Queues through the world's damage queue, or applies straight away if there is none
+	static void QueueDamage(const UObject* WorldContextObject, AActor* Victim, float Damage, AController* InstigatorController, AActor* DamageCauser);
+
+	void AddDamage(AActor* Victim, float Damage, AController* InstigatorController, AActor* DamageCauser);
+
+private:
+
+	UPROPERTY()
+	TArray<FQueuedDamage> PendingDamage;
+
+	//Victim to index in PendingDamage
+	TMap<AActor*, int32> VictimIndices;
+};
@@ -8,13 +8,25 @@
 #include "Blueprint/UserWidget.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "EnemyAIController.h"
-#include "BehaviorTree/BlackboardComponent.h"
 #include "Components/SphereComponent.h"
+#include "Components/BoxComponent.h"
 #include "FrameCharacter.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/BoxComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/DamageType.h"
 #include "Engine/SkeletalMeshSocket.h"
+#include "FXPoolSubsystem.h"
+#include "DamageQueueSubsystem.h"
+#include "EnemySignificanceSubsystem.h"
+#include "EnemyPerceptionSubsystem.h"
+#include "MeleeTraceComponent.h"
+#include "EnemyPoolSubsystem.h"
+#include "BrainComponent.h"
+#include "Components/WidgetComponent.h"
+#include "CorpseSubsystem.h"
+#include "EnemyRegistrySubsystem.h"
+#include "FrameGameModeBase.h"
+#include "GroundLootSubsystem.h"
 
 
 // Sets default values
@@ -25,7 +37,7 @@ AEnemy::AEnemy() :
 	bCanHitReact(true),
 	HitReactTimeMin(0.4f),
 	HitReactTimeMax(3.f),
-	HitPointDestroyTime(1.0f),
+	SightRadius(1500.f),
 	bStunned(false),
 	StunnedChance(0.5f),
 	AttackR(TEXT("Attack_R")),
@@ -35,32 +47,67 @@ AEnemy::AEnemy() :
 	AttackRD(TEXT("Attack_RD")),
 	AttackRDF(TEXT("Attack_RDF")),
 	AttackB(TEXT("Attack_B")),
+	MeleeTraceRadius(24.f),
 	BaseDamage(20.f),
 	LeftWeaponSocket(TEXT("WeaponTrailFX02")),
 	RightWeaponSocket(TEXT("WeaponRFXTrail02")),
+	LeftWeaponBone(TEXT("LeftWeaponBone")),
+	RightWeaponBone(TEXT("RightWeaponBone")),
+	LeftWeaponBladeStart(-8.f, -51.f, -9.f),
+	LeftWeaponBladeEnd(-8.f, 170.f, 30.f),
+	RightWeaponBladeStart(6.f, -161.f, -29.f),
+	RightWeaponBladeEnd(6.f, 44.f, 7.f),
 	bCanAttack(true),
 	AttackWaitTime(1.f),
 	bDying(false),
-	DeathTime(5.0f)
+	DeathTime(5.0f),
+	HitPointDestroyTime(1.0f),
+	LastDamagedTime(-1.f),
+	CombatMemory(3.f),
+	HordeMesh(nullptr),
+	CorpseMesh(nullptr),
+	TeamId(1),
+	LootClass(nullptr),
+	LootDropChance(0.5f)
 
 
 {
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
-	// AggroSphere created and attached to root
-	AggroSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AggroSphere"));
-	AggroSphere->SetupAttachment(GetRootComponent());
-
 	// Attack range sphere created and attached to root
 	AttackRangeSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AttackRange"));
 	AttackRangeSphere->SetupAttachment(GetRootComponent());
 
-	// Left and right weapon collision boxes constructed	
-	LeftWeaponCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("LeftWeaponBox"));
-	LeftWeaponCollision->SetupAttachment(GetMesh(), FName("LeftWeaponBone"));
-	RightWeaponCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("RightWeaponBox"));
-	RightWeaponCollision->SetupAttachment(GetMesh(), FName("RightWeaponBone"));
+#if WITH_EDITORONLY_DATA
+	// No collision, it only holds the radius until PostLoad moves it to SightRadius
+	AggroSphere_DEPRECATED = CreateEditorOnlyDefaultSubobject<USphereComponent>(TEXT("AggroSphere"));
+	if (AggroSphere_DEPRECATED)
+	{
+		AggroSphere_DEPRECATED->SetupAttachment(GetRootComponent());
+		AggroSphere_DEPRECATED->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+
+	// Same for the weapon boxes, PostLoad turns their extents into blade segments
+	LeftWeaponBox_DEPRECATED = CreateEditorOnlyDefaultSubobject<UBoxComponent>(TEXT("LeftWeaponBox"));
+	if (LeftWeaponBox_DEPRECATED)
+	{
+		LeftWeaponBox_DEPRECATED->SetupAttachment(GetMesh(), LeftWeaponBone);
+		LeftWeaponBox_DEPRECATED->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+	RightWeaponBox_DEPRECATED = CreateEditorOnlyDefaultSubobject<UBoxComponent>(TEXT("RightWeaponBox"));
+	if (RightWeaponBox_DEPRECATED)
+	{
+		RightWeaponBox_DEPRECATED->SetupAttachment(GetMesh(), RightWeaponBone);
+		RightWeaponBox_DEPRECATED->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+#endif
+
+	// Lets the significance subsystem lower animation rates through the mesh's update rate params
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+
+	// Sweeps the weapon blades during attack windows
+	MeleeTrace = CreateDefaultSubobject<UMeleeTraceComponent>(TEXT("MeleeTrace"));
 
 
 
@@ -71,50 +118,230 @@ void AEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 
-	AggroSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::AggroSphereOverlap);
 	AttackRangeSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::AttackRangeOverlap);
 	AttackRangeSphere->OnComponentEndOverlap.AddDynamic(this, &AEnemy::AttackRangeEndOverlap);
 
-	// Functions bound to overlap events for weapons
-	LeftWeaponCollision->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::OnLeftWeaponOverlap);
-	RightWeaponCollision->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::OnRightWeaponOverlap);
-	// Set collision presets for weapons
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	LeftWeaponCollision->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
-	LeftWeaponCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-	LeftWeaponCollision->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
-
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	RightWeaponCollision->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
-	RightWeaponCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-	RightWeaponCollision->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
+	// Weapon hits come from sweeps of the weapon sockets
+	MeleeTrace->SetTraceMesh(GetMesh());
+	MeleeTrace->OnMeleeHit.AddUObject(this, &AEnemy::OnMeleeHit);
 
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 	// Ignores camera
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
+
+	ResolveHitZones();
 	
+	// Prewarm pooled impact particles so the first hits don't create components
+	UFXPoolSubsystem* FXPool = GetWorld()->GetSubsystem<UFXPoolSubsystem>();
+	if (FXPool)
+	{
+		FXPool->Prewarm(ImpactParticles, 4);
+	}
+
 	// Get AI controller
 	EnemyController = Cast<AEnemyAIController>(GetController());
 
-	if (EnemyController)
+	StartBehavior();
+	RegisterWithSubsystems();
+}
+
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterFromSubsystems();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+// Blade along the box's longest axis, radius from its thickest other side. False while the box is still at its defaults
+static bool MigrateWeaponBox(UBoxComponent* Box, FVector& OutBladeStart, FVector& OutBladeEnd, float& OutRadius)
+{
+	if (Box == nullptr) return false;
+
+	const UBoxComponent* DefaultBox{ GetDefault<UBoxComponent>() };
+	if (Box->GetRelativeTransform().Equals(FTransform::Identity) && Box->GetUnscaledBoxExtent().Equals(DefaultBox->GetUnscaledBoxExtent())) return false;
+
+	const FVector HalfExtent{ Box->GetUnscaledBoxExtent() * Box->GetRelativeScale3D().GetAbs() };
+	int32 BladeAxis{ 0 };
+	for (int32 Axis = 1; Axis < 3; Axis++)
+	{
+		if (HalfExtent[Axis] > HalfExtent[BladeAxis]) BladeAxis = Axis;
+	}
+
+	FVector HalfBlade{ FVector::ZeroVector };
+	HalfBlade[BladeAxis] = HalfExtent[BladeAxis];
+	HalfBlade = Box->GetRelativeRotation().RotateVector(HalfBlade);
+	OutBladeStart = Box->GetRelativeLocation() - HalfBlade;
+	OutBladeEnd = Box->GetRelativeLocation() + HalfBlade;
+
+	OutRadius = 0.f;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		if (Axis != BladeAxis) OutRadius = FMath::Max(OutRadius, HalfExtent[Axis]);
+	}
+
+	// Reset so a resaved Blueprint keeps its blades and is not migrated again
+	Box->SetRelativeTransform(FTransform::Identity);
+	Box->SetBoxExtent(DefaultBox->GetUnscaledBoxExtent(), false);
+	return true;
+}
+
+void AEnemy::PostLoad()
+{
+	Super::PostLoad();
+
+	// The large minions authored shorter boxes than BP_Enemy, so each class keeps its own reach
+	float LeftRadius{ 0.f };
+	float RightRadius{ 0.f };
+	const bool bLeftMigrated{ MigrateWeaponBox(LeftWeaponBox_DEPRECATED, LeftWeaponBladeStart, LeftWeaponBladeEnd, LeftRadius) };
+	const bool bRightMigrated{ MigrateWeaponBox(RightWeaponBox_DEPRECATED, RightWeaponBladeStart, RightWeaponBladeEnd, RightRadius) };
+	if (bLeftMigrated || bRightMigrated)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("CanAttack"), true);
+		MeleeTraceRadius = FMath::Max(LeftRadius, RightRadius);
 	}
 
+	// Any radius off the component default was authored, BP_Enemy used 1000 and the large minions 1200
+	const float DefaultSphereRadius{ GetDefault<USphereComponent>()->GetUnscaledSphereRadius() };
+	if (AggroSphere_DEPRECATED && !FMath::IsNearlyEqual(AggroSphere_DEPRECATED->GetUnscaledSphereRadius(), DefaultSphereRadius))
+	{
+		SightRadius = AggroSphere_DEPRECATED->GetUnscaledSphereRadius();
+
+		// Reset so a resaved Blueprint keeps its SightRadius and is not migrated again
+		AggroSphere_DEPRECATED->SetSphereRadius(DefaultSphereRadius, false);
+	}
+}
+#endif
+
+void AEnemy::StartBehavior()
+{
+	if (EnemyController == nullptr) return;
+
+	EnemyController->SetCanAttack(true);
+
+	// Patrol points are local to wherever the enemy starts
 	const FVector WorldPatrolPoint = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint);
 	const FVector WorldPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
-	
+	EnemyController->SetPatrolPoints(WorldPatrolPoint, WorldPatrolPoint2);
+
+	EnemyController->RunBehaviorTree(BehaviorTree);
+}
+
+void AEnemy::RegisterWithSubsystems()
+{
+	UEnemyRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UEnemyRegistrySubsystem>();
+	if (Registry)
+	{
+		Registry->RegisterEnemy(this);
+	}
+
+	UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (Significance)
+	{
+		Significance->RegisterEnemy(this);
+	}
+
+	UEnemyPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (Perception)
+	{
+		Perception->RegisterEnemy(this);
+	}
+}
+
+void AEnemy::UnregisterFromSubsystems()
+{
+	UEnemyRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UEnemyRegistrySubsystem>();
+	if (Registry)
+	{
+		Registry->UnregisterEnemy(this);
+	}
+
+	UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (Significance)
+	{
+		Significance->UnregisterEnemy(this);
+	}
+
+	UEnemyPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (Perception)
+	{
+		Perception->UnregisterEnemy(this);
+	}
+}
+
+void AEnemy::DeactivatePooledEnemy()
+{
+	UnregisterFromSubsystems();
+	OnEnemyDied.Clear();
+
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	ClearHitPoints();
+	MeleeTrace->EndAllSwings();
 
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint"), WorldPatrolPoint);
+		EnemyController->StopMovement();
+		if (EnemyController->GetBrainComponent())
+		{
+			EnemyController->GetBrainComponent()->StopLogic(TEXT("Pooled"));
+		}
+	}
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetMesh()->bPauseAnims = true;
 
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint2"), WorldPatrolPoint2);
+	SetActorEnableCollision(false);
+	SetActorHiddenInGame(true);
+	SetActorTickEnabled(false);
+}
+
+void AEnemy::ResetPooledEnemy(const FTransform& SpawnTransform)
+{
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
 
-		EnemyController->RunBehaviorTree(BehaviorTree);
+	// Combat state back to the class defaults
+	Health = MaxHealth;
+	bDying = false;
+	bStunned = false;
+	bInAttackRange = false;
+	bCanAttack = true;
+	bCanHitReact = true;
+	LastDamagedTime = -1.f;
+	HideHealthBar();
+
+	// Drop whatever montage was playing when the enemy died
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance)
+	{
+		AnimInstance->StopAllMontages(0.f);
+	}
+	GetMesh()->bPauseAnims = false;
+
+	// Undo whatever the corpse was stripped of
+	GetMesh()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	// Widgets the Blueprint starts hidden, like the health bar, stay hidden until shown again
+	TInlineComponentArray<UWidgetComponent*> Widgets(this);
+	for (UWidgetComponent* Widget : Widgets)
+	{
+		const USceneComponent* Archetype{ Cast<USceneComponent>(Widget->GetArchetype()) };
+		Widget->SetComponentTickEnabled(true);
+		Widget->SetVisibility(Archetype ? Archetype->GetVisibleFlag() : true);
 	}
 
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Walking);
+
+	if (EnemyController)
+	{
+		EnemyController->SetActorTickEnabled(true);
+		EnemyController->ResetBlackboard();
+	}
+	StartBehavior();
+	RegisterWithSubsystems();
 }
 
 void AEnemy::ShowHealthBar_Implementation()
@@ -127,6 +354,8 @@ void AEnemy::Die()
 {
 	if (bDying) return;
 	bDying = true;
+
+	MeleeTrace->EndAllSwings();
 	
 	HideHealthBar();
 
@@ -138,9 +367,73 @@ void AEnemy::Die()
 
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("Dead"), true);
+		EnemyController->SetDead(true);
 		EnemyController->StopMovement();
 	}
+
+	// Counted as dead before the strip unregisters it, so the game mode sees the death
+	UEnemyRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UEnemyRegistrySubsystem>();
+	if (Registry)
+	{
+		Registry->MarkDead(this);
+	}
+	StripForCorpse();
+	DropLoot();
+
+	OnEnemyDied.Broadcast(this);
+
+	AFrameGameModeBase* GameMode = GetWorld()->GetAuthGameMode<AFrameGameModeBase>();
+	if (GameMode != nullptr)
+	{
+		GameMode->PawnKilled(this);
+	}
+}
+
+void AEnemy::DropLoot()
+{
+	if (LootClass == nullptr || FMath::FRand() >= LootDropChance) return;
+
+	// On the floor under the capsule rather than at its centre
+	const FVector LootLocation{ GetActorLocation() - FVector(0.f, 0.f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) };
+	const AItem* LootDefaults = LootClass->GetDefaultObject<AItem>();
+	UGroundLootSubsystem::DropLoot(this, LootClass, FTransform(FRotator(0.f, FMath::FRandRange(0.f, 360.f), 0.f), LootLocation),
+		LootDefaults->GetItemRarity(), LootDefaults->GetItemCount());
+}
+
+void AEnemy::StripForCorpse()
+{
+	UnregisterFromSubsystems();
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	if (HitNumbers.Num() > 0)
+	{
+		// Their own timers are gone, let the killing blow's numbers show out their time then remove them together
+		FTimerHandle HitNumberTimer;
+		GetWorldTimerManager().SetTimer(HitNumberTimer, this, &AEnemy::ClearHitPoints, HitPointDestroyTime);
+	}
+
+	// Nothing left to hit or overlap, and no movement to simulate
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+
+	TInlineComponentArray<UWidgetComponent*> Widgets(this);
+	for (UWidgetComponent* Widget : Widgets)
+	{
+		Widget->SetVisibility(false);
+		Widget->SetComponentTickEnabled(false);
+	}
+
+	// Blackboard is kept for the pool to reset, only the tree and controller stop
+	if (EnemyController)
+	{
+		if (EnemyController->GetBrainComponent())
+		{
+			EnemyController->GetBrainComponent()->StopLogic(TEXT("Dead"));
+		}
+		EnemyController->SetActorTickEnabled(false);
+	}
 }
 
 void AEnemy::PlayHitMontage(FName Section, float PlayRate)
@@ -179,7 +472,10 @@ void AEnemy::StoreHitPoint(UUserWidget* HitNumber, FVector Location)
 void AEnemy::DestroyHitPoint(UUserWidget* HitPoint)
 {
 	HitNumbers.Remove(HitPoint);
-	HitPoint->RemoveFromParent();
+	if (HitPoint)
+	{
+		HitPoint->RemoveFromParent();
+	}
 }
 
 void AEnemy::UpdateHitPoints()
@@ -194,23 +490,56 @@ void AEnemy::UpdateHitPoints()
 	}
 }
 
-void AEnemy::AggroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::ClearHitPoints()
 {
-	if (OtherActor == nullptr) return;
+	for (auto& HitPair : HitNumbers)
+	{
+		if (HitPair.Key)
+		{
+			HitPair.Key->RemoveFromParent();
+		}
+	}
+	HitNumbers.Empty();
+}
 
-	auto Character = Cast<AFrameCharacter>(OtherActor);
-	if (Character)
+void AEnemy::ResolveHitZones()
+{
+	USkeletalMeshComponent* EnemyMesh = GetMesh();
+	if (HitZones)
 	{
-		if (EnemyController)
+		HitZones->ResolveBoneZones(EnemyMesh, BoneHitZones);
+	}
+	else
+	{
+		// No asset, only the head bone itself counts as a headshot
+		BoneHitZones.Init(FResolvedHitZone(), EnemyMesh->GetNumBones());
+		const int32 HeadBoneIndex = EnemyMesh->GetBoneIndex(FName(*HeadBone));
+		if (BoneHitZones.IsValidIndex(HeadBoneIndex))
 		{
-			if (EnemyController->GetBlackboardComponent())
-			{
-				// Sets value of target Blackboard key
-				EnemyController->GetBlackboardComponent()->SetValueAsObject(TEXT("Target"), Character);
-			}
+			BoneHitZones[HeadBoneIndex].Zone = EHitZone::EHZ_Head;
 		}
 	}
-}	
+
+	// Traces against the physics asset report the body index, map each body to its bone's zone
+	BodyHitZones.Reset(EnemyMesh->Bodies.Num());
+	for (const FBodyInstance* Body : EnemyMesh->Bodies)
+	{
+		const int32 BoneIndex = Body ? Body->InstanceBoneIndex : INDEX_NONE;
+		BodyHitZones.Add(BoneHitZones.IsValidIndex(BoneIndex) ? BoneHitZones[BoneIndex] : FResolvedHitZone());
+	}
+}
+
+FResolvedHitZone AEnemy::GetHitZone(const FHitResult& HitResult) const
+{
+	if (HitResult.GetComponent() == GetMesh() && BodyHitZones.IsValidIndex(HitResult.Item))
+	{
+		return BodyHitZones[HitResult.Item];
+	}
+
+	// Hit without a body index, fall back to the bone
+	const int32 BoneIndex = GetMesh()->GetBoneIndex(HitResult.BoneName);
+	return BoneHitZones.IsValidIndex(BoneIndex) ? BoneHitZones[BoneIndex] : FResolvedHitZone();
+}
 
 void AEnemy::SetStun(bool Stunned)
 {
@@ -218,7 +547,7 @@ void AEnemy::SetStun(bool Stunned)
 
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("Stunned"), Stunned);
+		EnemyController->SetStunned(Stunned);
 	}
 }
 
@@ -231,7 +560,7 @@ void AEnemy::AttackRangeOverlap(UPrimitiveComponent* OverlappedComponent, AActor
 		bInAttackRange = true;
 		if (EnemyController)
 		{
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), true);
+			EnemyController->SetInAttackRange(true);
 		}
 	}	
 }
@@ -245,7 +574,7 @@ void AEnemy::AttackRangeEndOverlap(UPrimitiveComponent* OverlappedComponent, AAc
 		bInAttackRange = false;
 		if (EnemyController)
 		{
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), false);
+			EnemyController->SetInAttackRange(false);
 		}
 	}
 }
@@ -262,7 +591,7 @@ void AEnemy::PlayAttackMontage(FName Section, float PlayRate)
 	GetWorldTimerManager().SetTimer(AttackWaitTimer, this, &AEnemy::ResetCanAttack, AttackWaitTime);
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("CanAttack"), false);
+		EnemyController->SetCanAttack(false);
 	}
 }
 
@@ -301,7 +630,7 @@ void AEnemy::DoDamage(AFrameCharacter* Victim)
 {
 	if (Victim == nullptr) return;
 
-	UGameplayStatics::ApplyDamage(Victim, BaseDamage, EnemyController, this, UDamageType::StaticClass());
+	UDamageQueueSubsystem::QueueDamage(this, Victim, BaseDamage, EnemyController, this);
 		
 		if (Victim->GetMeleeAttackSound())
 		{
@@ -317,7 +646,7 @@ void AEnemy::SpawnHitParticles(AFrameCharacter* Victim, FName SocketName)
 			const FTransform SocketTransform { WeaponTip->GetSocketTransform(GetMesh()) };
 			if (Victim->GetHitParticles())
 			{
-				UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Victim->GetHitParticles(), SocketTransform);
+				UFXPoolSubsystem::SpawnEmitter(this, Victim->GetHitParticles(), SocketTransform);
 			}
 		}
 }
@@ -339,72 +668,86 @@ void AEnemy::ResetCanAttack()
 	bCanAttack = true;
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("CanAttack"), true);
+		EnemyController->SetCanAttack(true);
 	}
 }
 
 void AEnemy::FinishDeath()
 {
+	// Pose stays as the last evaluated frame with no more animation or skinning updates
 	GetMesh()->bPauseAnims = true;
-	GetWorldTimerManager().SetTimer(DeathTimer, this, &AEnemy::DestroyEnemy, DeathTime);
-}
+	GetMesh()->SetComponentTickEnabled(false);
 
-void AEnemy::DestroyEnemy()
-{
-	Destroy();
+	UCorpseSubsystem::AddCorpse(this, DeathTime);
 }
 
 
-void AEnemy::OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)	
-{
-	auto Character = Cast<AFrameCharacter>(OtherActor);
-	if (Character)
-	{
-		DoDamage(Character);
-		SpawnHitParticles(Character, LeftWeaponSocket);
-		AttemptStunCharacter(Character);
-	}
-}
-
-void AEnemy::OnRightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::OnMeleeHit(AActor* Victim, const FVector& ImpactPoint, FName SocketName)
 {
-	auto Character = Cast<AFrameCharacter>(OtherActor);
+	auto Character = Cast<AFrameCharacter>(Victim);
 	if (Character)
 	{
 		DoDamage(Character);
-		SpawnHitParticles(Character, RightWeaponSocket);
+		SpawnHitParticles(Character, SocketName == LeftWeaponBone ? LeftWeaponSocket : RightWeaponSocket);
 		AttemptStunCharacter(Character);
 	}
 }
 
 void AEnemy::ActivateLeftWeapon()
 {
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	MeleeTrace->BeginSwing(LeftWeaponBone, LeftWeaponBladeStart, LeftWeaponBladeEnd, MeleeTraceRadius);
 }
 
 void AEnemy::DeactivateLeftWeapon()
 {
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeleeTrace->EndSwing(LeftWeaponBone);
 }
 
 void AEnemy::ActivateRightWeapon()
 {
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	MeleeTrace->BeginSwing(RightWeaponBone, RightWeaponBladeStart, RightWeaponBladeEnd, MeleeTraceRadius);
 }
 
 void AEnemy::DeactivateRightWeapon()
 {
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeleeTrace->EndSwing(RightWeaponBone);
 }
 		
 
+bool AEnemy::IsInCombat() const
+{
+	if (bInAttackRange || bStunned) return true;
+
+	return LastDamagedTime >= 0.f && GetWorld()->GetTimeSeconds() - LastDamagedTime < CombatMemory;
+}
+
+void AEnemy::SetHordeState(float NewHealth, AActor* Target, const FVector& Velocity)
+{
+	Health = FMath::Clamp(NewHealth, 0.f, MaxHealth);
+	GetCharacterMovement()->Velocity = Velocity;
+
+	if (Target && EnemyController)
+	{
+		EnemyController->SetTarget(Target);
+	}
+}
+
+AActor* AEnemy::GetTarget() const
+{
+	if (EnemyController == nullptr) return nullptr;
+
+	return EnemyController->GetTarget();
+}
+
 // Called every frame
 void AEnemy::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	UpdateHitPoints();
-
+	if (HitNumbers.Num() > 0)
+	{
+		UpdateHitPoints();
+	}
 }
 
 // Called to bind functionality to input
@@ -422,7 +765,7 @@ void AEnemy::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, ACo
 	}
 	if (ImpactParticles)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, HitResult.Location, FRotator(0.f), true);
+		UFXPoolSubsystem::SpawnEmitter(this, ImpactParticles, HitResult.Location, FRotator(0.f));
 	}
 }
 
@@ -431,8 +774,10 @@ float AEnemy::TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEv
 	// Set Blackboard key to aggro enemy
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsObject(FName("Target"), DamageCauser);
+		EnemyController->SetTarget(DamageCauser);
 	}
+
+	LastDamagedTime = GetWorld()->GetTimeSeconds();
 	
 	if (Health - DamageAmount <= 0.f)
 	{
@@ -5,8 +5,11 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "BulletHitInterface.h"
+#include "HitZoneDataAsset.h"
 #include "Enemy.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEnemyDied, class AEnemy*);
+
 UCLASS()
 class FRAME_API AEnemy : public ACharacter, public IBulletHitInterface
 {
@@ -20,6 +23,20 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+#if WITH_EDITOR
+	// Carries what Blueprints authored on the removed AggroSphere and weapon boxes over to their replacements
+	virtual void PostLoad() override;
+#endif
+
+	// Seeds the blackboard and runs the behavior tree from the current transform
+	void StartBehavior();
+
+	// Registry, significance and perception tracking, left while parked in the enemy pool or dead
+	void RegisterWithSubsystems();
+	void UnregisterFromSubsystems();
+
 	UFUNCTION(BlueprintNativeEvent)
 	void ShowHealthBar();
 	void ShowHealthBar_Implementation();
@@ -33,6 +50,7 @@ protected:
 
 	void ResetHitReactTimer();
 
+	// Kept for game modes whose HUD is not an AFrameHUD, enemy Blueprints add their hit number widgets here
 	UFUNCTION(BlueprintCallable)
 	void StoreHitPoint(UUserWidget* HitNumber, FVector Location);
 	
@@ -41,14 +59,11 @@ protected:
 
 	void UpdateHitPoints();
 
-	// Function called when player overlaps with AggroSphere - triggers hostile enemy behaviour
-	UFUNCTION()
-	void AggroSphereOverlap(UPrimitiveComponent* OverlappedComponent, 
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp, 
-		int32 OtherBodyIndex, 
-		bool bFromSweep, 
-		const FHitResult& SweepResult);
+	// Removes every hit number widget still on screen
+	void ClearHitPoints();
+
+	//Builds the per-body hit zone table from HitZones once the mesh has its bodies
+	void ResolveHitZones();
 
 	UFUNCTION(BlueprintCallable)
 	void SetStun(bool Stunned);
@@ -73,23 +88,10 @@ protected:
 	UFUNCTION(BlueprintPure)
 	FName GetAttackSectionName();
 
-	UFUNCTION()
-	void OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, 
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp, 
-		int32 OtherBodyIndex, 
-		bool bFromSweep, 
-		const FHitResult& SweepResult);
+	// Called once per victim per swing by the melee trace component
+	void OnMeleeHit(AActor* Victim, const FVector& ImpactPoint, FName SocketName);
 
-	UFUNCTION()
-	void OnRightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, 
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp, 
-		int32 OtherBodyIndex, 
-		bool bFromSweep, 
-		const FHitResult& SweepResult);
-
-	// Activates/deactivates weapon boxes
+	// Opens/closes the hit window of each weapon socket, called from anim notifies
 	UFUNCTION(BlueprintCallable)
 	void ActivateLeftWeapon();
 	UFUNCTION(BlueprintCallable)
@@ -106,12 +108,13 @@ protected:
 
 	void ResetCanAttack();
 
+	// Drops collision, tick, AI and widgets the moment the enemy dies, the mesh keeps animating the death
+	void StripForCorpse();
+
+	// Freezes the death pose and hands the corpse to the corpse subsystem
 	UFUNCTION(BlueprintCallable)
 	void FinishDeath();
 
-	UFUNCTION()
-	void DestroyEnemy();
-
 
 
 private:
@@ -132,10 +135,20 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float MaxHealth;
 
-	//Head bone name
+	//Head bone name, used as the head zone when no hit zone asset is set
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	FString HeadBone;
 
+	//Bone to zone and damage multiplier mapping for this enemy class
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UHitZoneDataAsset* HitZones;
+
+	//Hit zone per bone index of the mesh
+	TArray<FResolvedHitZone> BoneHitZones;
+
+	//Hit zone per physics body index of the mesh, matches FHitResult::Item
+	TArray<FResolvedHitZone> BodyHitZones;
+
 	//Display health bar once enemy hit
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float HealthBarDisplayTime;
@@ -156,14 +169,6 @@ private:
 
 	bool bCanHitReact;
 
-	//Store locations of hit point widgets and hit locations
-	UPROPERTY(VisibleAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	TMap<UUserWidget*, FVector> HitNumbers;
-
-	//Time elapsed before hit points removed off screen
-	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	float HitPointDestroyTime;
-
 	//AI Behaviour Tree for enemies
 	UPROPERTY(EditAnywhere, Category = "Behavior Tree", meta = (AllowPrivateAccess = "true"))
 	class UBehaviorTree* BehaviorTree;
@@ -178,9 +183,15 @@ private:
 
 	class AEnemyAIController* EnemyController;
 
-	// Overlap sphere to determine when enemy is hostile to the player
-	UPROPERTY(Editanywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	class USphereComponent* AggroSphere;
+	// Distance the enemy can spot targets from, checked with line of sight by the perception subsystem
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float SightRadius;
+
+#if WITH_EDITORONLY_DATA
+	// Old aggro sphere, kept in the editor only so Blueprints still load its radius for PostLoad to migrate
+	UPROPERTY()
+	class USphereComponent* AggroSphere_DEPRECATED;
+#endif
 
 	// True when enemy is hit and playing the hit animation
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -196,7 +207,7 @@ private:
 
 	// Attack range sphere
 	UPROPERTY(Editanywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	USphereComponent* AttackRangeSphere;
+	class USphereComponent* AttackRangeSphere;
 
 	// Animations for attacks
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -211,24 +222,55 @@ private:
 	FName AttackRDF;
 	FName AttackB;
 
-	// Collision volume for weapon in left hand socket
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	class UBoxComponent* LeftWeaponCollision;
+	// Sweeps the weapon sockets while an attack window is open
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UMeleeTraceComponent* MeleeTrace;
 
-	// Collision volume for weapon in right hand socket
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	UBoxComponent* RightWeaponCollision;
+	// Radius swept around each weapon blade, scaled with the mesh
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float MeleeTraceRadius;
 
 	// Amount of damage enemy can inflict on player
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float BaseDamage;
 
+	// Weapon tip sockets hit particles spawn at
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	FName LeftWeaponSocket;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	FName RightWeaponSocket;	
 
+	// Bones holding the weapons, the blades are swept in their space
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FName LeftWeaponBone;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FName RightWeaponBone;
+
+	// Blade ends relative to LeftWeaponBone, defaults match BP_Enemy's old weapon box
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FVector LeftWeaponBladeStart;
+
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FVector LeftWeaponBladeEnd;
+
+	// Blade ends relative to RightWeaponBone
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FVector RightWeaponBladeStart;
+
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FVector RightWeaponBladeEnd;
+
+#if WITH_EDITORONLY_DATA
+	// Old weapon collision boxes, kept in the editor only so PostLoad can size the blades from them
+	UPROPERTY()
+	class UBoxComponent* LeftWeaponBox_DEPRECATED;
+
+	UPROPERTY()
+	class UBoxComponent* RightWeaponBox_DEPRECATED;
+#endif
+
 	// True when enemy can attack
 	UPROPERTY(VisibleAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	bool bCanAttack;
@@ -244,13 +286,49 @@ private:
 	UAnimMontage* DeathMontage;
 
 	bool bDying;
-	
-	FTimerHandle DeathTimer;
 
 	// Allows mesh to remain in world before disappearing - time after death before destroy
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float DeathTime;
 
+	//Store locations of hit point widgets and hit locations
+	UPROPERTY(VisibleAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	TMap<UUserWidget*, FVector> HitNumbers;
+
+	//Time elapsed before hit points removed off screen
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float HitPointDestroyTime;
+
+	// World time of the last damage taken, negative before the first hit
+	float LastDamagedTime;
+
+	// Seconds after taking damage the enemy still counts as fighting - kept at full rate, as an actor and on its target
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float CombatMemory;
+
+	// Instanced stand-in drawn while the enemy is a horde entity, the class cannot join a horde without one
+	UPROPERTY(EditAnywhere, Category = Horde, meta = (AllowPrivateAccess = "true"))
+	class UStaticMesh* HordeMesh;
+
+	// Static stand-in for the frozen death pose, authored in the skeletal mesh's space. Without one, corpses past the cap go straight back to the pool
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UStaticMesh* CorpseMesh;
+
+	// Team counted by the enemy registry, the player is not on any enemy team
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	uint8 TeamId;
+
+	// Pickup left on the ground on death with its default rarity and count, none drops nothing
+	UPROPERTY(EditAnywhere, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class AItem> LootClass;
+
+	// Chance of dropping LootClass on death
+	UPROPERTY(EditAnywhere, Category = Loot, meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "1.0"))
+	float LootDropChance;
+
+	// Drops LootClass through the ground loot subsystem, called from Die
+	void DropLoot();
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -264,8 +342,41 @@ public:
 
 	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
 
+	// Widget damage number, shown by the hitscan resolver when the HUD cannot draw damage numbers itself
 	UFUNCTION(BlueprintImplementableEvent)
 	void ShowHitPoint(int32 Damage, FVector HitLocation, bool bHeadshot);
 
+	//Zone of a hit on this enemy, looked up by body or bone index
+	FResolvedHitZone GetHitZone(const FHitResult& HitResult) const;
+
 	FORCEINLINE UBehaviorTree* GetBehaviorTree() const { return BehaviorTree; }
+
+	// True while in attack range, stunned or within CombatMemory seconds of taking damage
+	bool IsInCombat() const;
+
+	// Hides the enemy and stops its AI, movement, collision and timers while it waits in the enemy pool
+	void DeactivatePooledEnemy();
+
+	// Brings a parked enemy back at a new transform with full health and a fresh blackboard and behavior tree
+	void ResetPooledEnemy(const FTransform& SpawnTransform);
+
+	// Broadcast when the enemy starts dying, listeners are cleared when it goes back to the pool
+	FOnEnemyDied OnEnemyDied;
+
+	// Carries a horde entity's state over once it has been promoted to this actor
+	void SetHordeState(float NewHealth, AActor* Target, const FVector& Velocity);
+
+	// Actor set as the Target blackboard key, null when not aggroed
+	AActor* GetTarget() const;
+
+	FORCEINLINE float GetHealth() const { return Health; }
+	FORCEINLINE float GetMaxHealth() const { return MaxHealth; }
+	FORCEINLINE bool IsDying() const { return bDying; }
+	FORCEINLINE FVector GetPatrolPoint() const { return PatrolPoint; }
+	FORCEINLINE FVector GetPatrolPoint2() const { return PatrolPoint2; }
+	FORCEINLINE UStaticMesh* GetHordeMesh() const { return HordeMesh; }
+	FORCEINLINE UStaticMesh* GetCorpseMesh() const { return CorpseMesh; }
+	FORCEINLINE float GetSightRadius() const { return SightRadius; }
+	FORCEINLINE uint8 GetTeamId() const { return TeamId; }
+	FORCEINLINE AEnemyAIController* GetEnemyController() const { return EnemyController; }
 };
@@ -4,17 +4,37 @@
 #include "EnemyAIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
+#include "ThrottledBehaviorTreeComponent.h"
 #include "Enemy.h"
 #include "BehaviorTree/BehaviorTree.h"
-#include "FrameCharacter.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+namespace
+{
+    // Writes only when the value differs, so decorators observing the key are not re-evaluated for nothing
+    template<typename TKeyType>
+    void SetKeyValue(UBlackboardComponent* Blackboard, FBlackboard::FKey Key, typename TKeyType::FDataType Value)
+    {
+        if (Key == FBlackboard::InvalidKey) return;
+        if (Blackboard->GetValue<TKeyType>(Key) == Value) return;
+
+        Blackboard->SetValue<TKeyType>(Key, Value);
+    }
+}
 
 AEnemyAIController::AEnemyAIController()
 {
     BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
     check(BlackboardComponent);
 
-    BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
+    BehaviorTreeComponent = CreateDefaultSubobject<UThrottledBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
     check(BehaviorTreeComponent);
+
+    // RunBehaviorTree reuses this rather than creating a plain component, so significance can throttle it
+    BrainComponent = BehaviorTreeComponent;
 }
 
 void AEnemyAIController::OnPossess(APawn* InPawn)
@@ -29,17 +49,94 @@ void AEnemyAIController::OnPossess(APawn* InPawn)
         if (Enemy->GetBehaviorTree())
         {
             BlackboardComponent->InitializeBlackboard(*(Enemy->GetBehaviorTree()->BlackboardAsset));
+            ResolveBlackboardKeys();
         }
     }
 }
 
-bool AEnemyAIController::IsDead() const
+void AEnemyAIController::ResolveBlackboardKeys()
+{
+    BlackboardKeys = FEnemyBlackboardKeys();
+
+    const UBlackboardData* BlackboardAsset = BlackboardComponent->GetBlackboardAsset();
+    if (BlackboardAsset == nullptr) return;
+
+    TArray<FString> BadKeys;
+    auto ResolveKey = [&](const TCHAR* KeyName, TSubclassOf<UBlackboardKeyType> KeyType, FBlackboard::FKey& OutKey)
+    {
+        const FBlackboard::FKey Key = BlackboardAsset->GetKeyID(FName(KeyName));
+        if (Key == FBlackboard::InvalidKey || BlackboardAsset->GetKeyType(Key) != KeyType)
+        {
+            BadKeys.Add(FString::Printf(TEXT("%s (%s)"), KeyName, *KeyType->GetName()));
+            return;
+        }
+        OutKey = Key;
+    };
+
+    ResolveKey(TEXT("CanAttack"), UBlackboardKeyType_Bool::StaticClass(), BlackboardKeys.CanAttack);
+    ResolveKey(TEXT("PatrolPoint"), UBlackboardKeyType_Vector::StaticClass(), BlackboardKeys.PatrolPoint);
+    ResolveKey(TEXT("PatrolPoint2"), UBlackboardKeyType_Vector::StaticClass(), BlackboardKeys.PatrolPoint2);
+    ResolveKey(TEXT("Target"), UBlackboardKeyType_Object::StaticClass(), BlackboardKeys.Target);
+    ResolveKey(TEXT("Stunned"), UBlackboardKeyType_Bool::StaticClass(), BlackboardKeys.Stunned);
+    ResolveKey(TEXT("InAttackRange"), UBlackboardKeyType_Bool::StaticClass(), BlackboardKeys.InAttackRange);
+    ResolveKey(TEXT("Dead"), UBlackboardKeyType_Bool::StaticClass(), BlackboardKeys.Dead);
+    ResolveKey(TEXT("CharacterIsDead"), UBlackboardKeyType_Bool::StaticClass(), BlackboardKeys.CharacterIsDead);
+
+    // Fires once per session, writes to a bad key are skipped rather than crashing
+    ensureMsgf(BadKeys.Num() == 0, TEXT("Blackboard %s is missing or mistyped keys: %s"),
+        *BlackboardAsset->GetName(), *FString::Join(BadKeys, TEXT(", ")));
+}
+
+void AEnemyAIController::SetCanAttack(bool bCanAttack)
+{
+    SetKeyValue<UBlackboardKeyType_Bool>(BlackboardComponent, BlackboardKeys.CanAttack, bCanAttack);
+}
+
+void AEnemyAIController::SetPatrolPoints(const FVector& PatrolPoint, const FVector& PatrolPoint2)
+{
+    SetKeyValue<UBlackboardKeyType_Vector>(BlackboardComponent, BlackboardKeys.PatrolPoint, PatrolPoint);
+    SetKeyValue<UBlackboardKeyType_Vector>(BlackboardComponent, BlackboardKeys.PatrolPoint2, PatrolPoint2);
+}
+
+void AEnemyAIController::SetTarget(AActor* Target)
+{
+    SetKeyValue<UBlackboardKeyType_Object>(BlackboardComponent, BlackboardKeys.Target, Target);
+}
+
+void AEnemyAIController::SetStunned(bool bStunned)
+{
+    SetKeyValue<UBlackboardKeyType_Bool>(BlackboardComponent, BlackboardKeys.Stunned, bStunned);
+}
+
+void AEnemyAIController::SetInAttackRange(bool bInAttackRange)
+{
+    SetKeyValue<UBlackboardKeyType_Bool>(BlackboardComponent, BlackboardKeys.InAttackRange, bInAttackRange);
+}
+
+void AEnemyAIController::SetDead(bool bDead)
 {
-    AFrameCharacter* ControllingCharacter = Cast<AFrameCharacter>(GetPawn());
-    if (ControllingCharacter != nullptr)
+    SetKeyValue<UBlackboardKeyType_Bool>(BlackboardComponent, BlackboardKeys.Dead, bDead);
+}
+
+void AEnemyAIController::SetCharacterIsDead(bool bCharacterIsDead)
+{
+    SetKeyValue<UBlackboardKeyType_Bool>(BlackboardComponent, BlackboardKeys.CharacterIsDead, bCharacterIsDead);
+}
+
+void AEnemyAIController::ResetBlackboard()
+{
+    const UBlackboardData* BlackboardAsset = BlackboardComponent->GetBlackboardAsset();
+    if (BlackboardAsset == nullptr) return;
+
+    for (int32 Key = 0; Key < BlackboardAsset->GetNumKeys(); Key++)
     {
-        ControllingCharacter->Die();
+        BlackboardComponent->ClearValue(static_cast<FBlackboard::FKey>(Key));
     }
+}
+
+AActor* AEnemyAIController::GetTarget() const
+{
+    if (BlackboardKeys.Target == FBlackboard::InvalidKey) return nullptr;
 
-    return true;
+    return Cast<AActor>(BlackboardComponent->GetValue<UBlackboardKeyType_Object>(BlackboardKeys.Target));
 }
\ No newline at end of file
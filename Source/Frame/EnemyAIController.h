@@ -4,8 +4,22 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
 #include "EnemyAIController.generated.h"
 
+//Key IDs of the enemy blackboard, resolved once on possession instead of looked up by name on every write
+struct FEnemyBlackboardKeys
+{
+	FBlackboard::FKey CanAttack = FBlackboard::InvalidKey;
+	FBlackboard::FKey PatrolPoint = FBlackboard::InvalidKey;
+	FBlackboard::FKey PatrolPoint2 = FBlackboard::InvalidKey;
+	FBlackboard::FKey Target = FBlackboard::InvalidKey;
+	FBlackboard::FKey Stunned = FBlackboard::InvalidKey;
+	FBlackboard::FKey InAttackRange = FBlackboard::InvalidKey;
+	FBlackboard::FKey Dead = FBlackboard::InvalidKey;
+	FBlackboard::FKey CharacterIsDead = FBlackboard::InvalidKey;
+};
+
 /**
  * 
  */
@@ -19,9 +33,24 @@ public:
 
 	virtual void OnPossess(APawn* InPawn) override;
 
-	bool IsDead() const;
+	// Typed blackboard writes, each skipped when the key already holds the value so observers are not woken
+	void SetCanAttack(bool bCanAttack);
+	void SetPatrolPoints(const FVector& PatrolPoint, const FVector& PatrolPoint2);
+	void SetTarget(AActor* Target);
+	void SetStunned(bool bStunned);
+	void SetInAttackRange(bool bInAttackRange);
+	void SetDead(bool bDead);
+	void SetCharacterIsDead(bool bCharacterIsDead);
+
+	AActor* GetTarget() const;
+
+	// Clears every key back to its default, for enemies coming out of the enemy pool
+	void ResetBlackboard();
 
 private:
+	// Resolves every key and reports any the blackboard asset is missing or has with the wrong type
+	void ResolveBlackboardKeys();
+
 	// Blackboard AI component for this enemy
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
 	class UBlackboardComponent* BlackboardComponent;
@@ -30,8 +59,10 @@ private:
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
 	class UBehaviorTreeComponent* BehaviorTreeComponent;
 
+	FEnemyBlackboardKeys BlackboardKeys;
+
 public:
 
 	FORCEINLINE UBlackboardComponent* GetBlackboardComponent() const { return BlackboardComponent; }
 	
-};
+};
\ No newline at end of file
@@ -0,0 +1,11 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyPerceptionSettings.h"
+
+UEnemyPerceptionSettings::UEnemyPerceptionSettings() :
+	CellSize(1000.f),
+	MaxChecksPerFrame(16),
+	TargetForgetTime(5.f)
+{
+}
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "EnemyPerceptionSettings.generated.h"
+
+/**
+ * Budget and memory of the enemy perception subsystem, editable under Project Settings > Game > Enemy Perception
+ * and saved to DefaultGame.ini. Sight range itself is per enemy, see AEnemy::SightRadius.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Enemy Perception"))
+class FRAME_API UEnemyPerceptionSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyPerceptionSettings();
+
+	virtual FName GetCategoryName() const override { return FName("Game"); }
+
+	//Cell size of the target grid, read when a world's perception subsystem is created
+	UPROPERTY(Config, EditAnywhere, Category = Perception, meta = (ClampMin = "1.0"))
+	float CellSize;
+
+	//Enemies checked per frame, the same however many are alive
+	UPROPERTY(Config, EditAnywhere, Category = Perception, meta = (ClampMin = "1"))
+	int32 MaxChecksPerFrame;
+
+	//Seconds out of sight before an enemy gives up on its target
+	UPROPERTY(Config, EditAnywhere, Category = Perception, meta = (ClampMin = "0.0"))
+	float TargetForgetTime;
+};
@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyPerceptionSubsystem.h"
+#include "Enemy.h"
+#include "EnemyAIController.h"
+#include "EnemyPerceptionSettings.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Enemy Perception"), STAT_UpdateEnemyPerception, STATGROUP_Frame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Traces"), STAT_PerceptionTraces, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Perceiving Enemies"), STAT_PerceivingEnemies, STATGROUP_Frame);
+
+UEnemyPerceptionSubsystem::UEnemyPerceptionSubsystem() :
+	TargetGrid(GetDefault<UEnemyPerceptionSettings>()->CellSize),
+	NextPerceiver(0)
+{
+	TraceDelegate.BindUObject(this, &UEnemyPerceptionSubsystem::OnTraceCompleted);
+}
+
+void UEnemyPerceptionSubsystem::Deinitialize()
+{
+	Targets.Empty();
+	TargetGrid.Reset();
+	Perceivers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyPerceptionSubsystem::RegisterTarget(AActor* Target)
+{
+	if (Target == nullptr || TargetGrid.Contains(Target)) return;
+
+	FPerceptionTarget Entry;
+	Entry.Actor = Target;
+	Entry.GridKey = Target;
+	Targets.Add(Entry);
+	TargetGrid.Update(Target, Target->GetActorLocation());
+}
+
+void UEnemyPerceptionSubsystem::UnregisterTarget(AActor* Target)
+{
+	Targets.RemoveAllSwap([Target](const FPerceptionTarget& Entry) { return Entry.GridKey == Target; });
+	TargetGrid.Remove(Target);
+}
+
+void UEnemyPerceptionSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr) return;
+
+	FPerceiver Perceiver;
+	Perceiver.Enemy = Enemy;
+	Perceivers.Add(Perceiver);
+}
+
+void UEnemyPerceptionSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	for (auto It = Perceivers.CreateIterator(); It; ++It)
+	{
+		if (It->Enemy == Enemy)
+		{
+			//A trace still in flight finds its slot gone or reused and is ignored
+			It.RemoveCurrent();
+			return;
+		}
+	}
+}
+
+void UEnemyPerceptionSubsystem::Tick(float DeltaTime)
+{
+	if (Perceivers.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_UpdateEnemyPerception);
+
+	UpdateTargets();
+
+	//Round robin over the sparse slots, holes do not use up the budget
+	const int32 MaxIndex{ Perceivers.GetMaxIndex() };
+	int32 ChecksLeft{ FMath::Min(GetDefault<UEnemyPerceptionSettings>()->MaxChecksPerFrame, Perceivers.Num()) };
+	for (int32 Visited = 0; Visited < MaxIndex && ChecksLeft > 0; Visited++)
+	{
+		if (NextPerceiver >= MaxIndex)
+		{
+			NextPerceiver = 0;
+		}
+		const int32 PerceiverIndex{ NextPerceiver++ };
+		if (!Perceivers.IsAllocated(PerceiverIndex)) continue;
+
+		CheckPerceiver(PerceiverIndex);
+		ChecksLeft--;
+	}
+
+	SET_DWORD_STAT(STAT_PerceivingEnemies, Perceivers.Num());
+}
+
+void UEnemyPerceptionSubsystem::UpdateTargets()
+{
+	for (int32 i = Targets.Num() - 1; i >= 0; i--)
+	{
+		const AActor* Target = Targets[i].Actor.Get();
+		if (Target == nullptr)
+		{
+			TargetGrid.Remove(Targets[i].GridKey);
+			Targets.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+		TargetGrid.Update(Target, Target->GetActorLocation());
+	}
+}
+
+void UEnemyPerceptionSubsystem::CheckPerceiver(int32 PerceiverIndex)
+{
+	FPerceiver& Perceiver = Perceivers[PerceiverIndex];
+	AEnemy* Enemy = Perceiver.Enemy.Get();
+	if (Enemy == nullptr)
+	{
+		Perceivers.RemoveAt(PerceiverIndex);
+		return;
+	}
+
+	AEnemyAIController* EnemyController = Enemy->GetEnemyController();
+	if (EnemyController == nullptr || Enemy->IsDying() || Perceiver.PendingTrace.IsValid()) return;
+
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	AActor* CurrentTarget = EnemyController->GetTarget();
+	if (CurrentTarget != Perceiver.TrackedTarget.Get())
+	{
+		//Set from elsewhere, such as taking damage
+		Perceiver.TrackedTarget = CurrentTarget;
+		Perceiver.LastSeenTime = Now;
+	}
+
+	if (CurrentTarget && Now - Perceiver.LastSeenTime > GetDefault<UEnemyPerceptionSettings>()->TargetForgetTime && !Enemy->IsInCombat())
+	{
+		EnemyController->SetTarget(nullptr);
+		Perceiver.TrackedTarget.Reset();
+		CurrentTarget = nullptr;
+	}
+
+	//Keep checking the current target while it is in range, otherwise look at the closest one
+	const FVector EyeLocation{ Enemy->GetPawnViewLocation() };
+	const float SightRadius{ Enemy->GetSightRadius() };
+	TArray<AActor*> NearbyTargets;
+	TargetGrid.Query(EyeLocation, SightRadius, NearbyTargets);
+	if (NearbyTargets.Num() == 0) return;
+
+	AActor* Candidate{ nullptr };
+	if (CurrentTarget && NearbyTargets.Contains(CurrentTarget))
+	{
+		Candidate = CurrentTarget;
+	}
+	else
+	{
+		float ClosestDistanceSquared{ TNumericLimits<float>::Max() };
+		for (AActor* Target : NearbyTargets)
+		{
+			const float DistanceSquared{ FVector::DistSquared(EyeLocation, Target->GetActorLocation()) };
+			if (DistanceSquared < ClosestDistanceSquared)
+			{
+				ClosestDistanceSquared = DistanceSquared;
+				Candidate = Target;
+			}
+		}
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(EnemyPerception), false, Enemy);
+	QueryParams.AddIgnoredActor(Candidate);
+
+	Perceiver.Candidate = Candidate;
+	Perceiver.PendingTrace = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, EyeLocation, Candidate->GetActorLocation(),
+		ECollisionChannel::ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, static_cast<uint32>(PerceiverIndex));
+	INC_DWORD_STAT(STAT_PerceptionTraces);
+}
+
+void UEnemyPerceptionSubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	const int32 PerceiverIndex{ static_cast<int32>(Datum.UserData) };
+	if (!Perceivers.IsValidIndex(PerceiverIndex) || !(Perceivers[PerceiverIndex].PendingTrace == Handle)) return;
+
+	FPerceiver& Perceiver = Perceivers[PerceiverIndex];
+	Perceiver.PendingTrace = FTraceHandle();
+
+	//Anything blocking between eye and target means it is out of sight
+	if (FHitResult::GetFirstBlockingHit(Datum.OutHits)) return;
+
+	AEnemy* Enemy = Perceiver.Enemy.Get();
+	AActor* Candidate = Perceiver.Candidate.Get();
+	AEnemyAIController* EnemyController = Enemy ? Enemy->GetEnemyController() : nullptr;
+	if (EnemyController == nullptr || Candidate == nullptr || Enemy->IsDying()) return;
+
+	EnemyController->SetTarget(Candidate);
+	Perceiver.TrackedTarget = Candidate;
+	Perceiver.LastSeenTime = GetWorld()->GetTimeSeconds();
+}
+
+TStatId UEnemyPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPerceptionSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "SpatialHashGrid.h"
+#include "EnemyPerceptionSubsystem.generated.h"
+
+class AEnemy;
+
+//Actor enemies can acquire, with the pointer it is keyed by in the grid
+struct FPerceptionTarget
+{
+	TWeakObjectPtr<AActor> Actor;
+	AActor* GridKey = nullptr;
+};
+
+//Enemy looking for targets and the state of its last sight check
+struct FPerceiver
+{
+	TWeakObjectPtr<AEnemy> Enemy;
+
+	//Target the pending trace is checking
+	TWeakObjectPtr<AActor> Candidate;
+	FTraceHandle PendingTrace;
+
+	//Blackboard target LastSeenTime refers to, a new target counts as just seen
+	TWeakObjectPtr<AActor> TrackedTarget;
+
+	//World time the enemy last saw its blackboard target
+	float LastSeenTime = 0.f;
+};
+
+/**
+ * Acquires targets for every enemy from a spatial grid of registered targets, with line of sight checked
+ * by async traces. A fixed number of enemies is checked each frame in round robin, so the per-frame
+ * cost stays flat as enemy count grows and only the time between checks for one enemy gets longer.
+ * Results go through the enemy blackboard, and targets out of sight for long enough are forgotten.
+ */
+UCLASS()
+class FRAME_API UEnemyPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyPerceptionSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterTarget(AActor* Target);
+	void UnregisterTarget(AActor* Target);
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+private:
+
+	//Moves every target to where it is now, dropping destroyed ones
+	void UpdateTargets();
+
+	//Picks the closest target in sight range and starts a line of sight trace to it
+	void CheckPerceiver(int32 PerceiverIndex);
+
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	TArray<FPerceptionTarget> Targets;
+	TSpatialHashGrid<AActor*> TargetGrid;
+
+	//Sparse so a perceiver's index stays valid as trace user data while others leave
+	TSparseArray<FPerceiver> Perceivers;
+
+	//Perceiver checked next, wraps around
+	int32 NextPerceiver;
+
+	FTraceDelegate TraceDelegate;
+};
@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyPoolSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Enemy.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Activate Pooled Enemies"), STAT_ActivatePooledEnemies, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Hits"), STAT_EnemyPoolHits, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Misses"), STAT_EnemyPoolMisses, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Enemies"), STAT_PooledEnemies, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Enemy Activations"), STAT_QueuedEnemyActivations, STATGROUP_Frame);
+
+namespace EnemyPool
+{
+	//Spawns a new enemy whose controller exists before BeginPlay starts the behavior tree
+	AEnemy* CreateEnemy(UWorld* World, TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform)
+	{
+		AEnemy* Enemy = World->SpawnActorDeferred<AEnemy>(EnemyClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (Enemy)
+		{
+			Enemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+			UGameplayStatics::FinishSpawningActor(Enemy, SpawnTransform);
+		}
+		return Enemy;
+	}
+}
+
+void UEnemyPoolSubsystem::Deinitialize()
+{
+	//Actors go with the world, only drop the references
+	Buckets.Empty();
+	QueuedActivations.Empty();
+
+	Super::Deinitialize();
+}
+
+AEnemy* UEnemyPoolSubsystem::SpawnEnemy(const UObject* WorldContextObject, TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform)
+{
+	if (EnemyClass == nullptr || WorldContextObject == nullptr) return nullptr;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr) return nullptr;
+
+	UEnemyPoolSubsystem* EnemyPool = World->GetSubsystem<UEnemyPoolSubsystem>();
+	if (EnemyPool)
+	{
+		return EnemyPool->Acquire(EnemyClass, SpawnTransform);
+	}
+	return EnemyPool::CreateEnemy(World, EnemyClass, SpawnTransform);
+}
+
+void UEnemyPoolSubsystem::ReleaseEnemy(const UObject* WorldContextObject, AEnemy* Enemy)
+{
+	if (!IsValid(Enemy)) return;
+
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UEnemyPoolSubsystem* EnemyPool = World ? World->GetSubsystem<UEnemyPoolSubsystem>() : nullptr;
+	if (EnemyPool)
+	{
+		EnemyPool->Release(Enemy);
+		return;
+	}
+	Enemy->Destroy();
+}
+
+AEnemy* UEnemyPoolSubsystem::Acquire(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform)
+{
+	if (EnemyClass == nullptr) return nullptr;
+
+	FEnemyPoolBucket& Bucket = Buckets.FindOrAdd(EnemyClass.Get());
+	while (Bucket.FreeEnemies.Num() > 0)
+	{
+		AEnemy* Enemy = Bucket.FreeEnemies.Pop(false);
+		if (!IsValid(Enemy)) continue;
+
+		PoolHits++;
+		INC_DWORD_STAT(STAT_EnemyPoolHits);
+		DEC_DWORD_STAT(STAT_PooledEnemies);
+
+		Enemy->ResetPooledEnemy(SpawnTransform);
+		return Enemy;
+	}
+
+	PoolMisses++;
+	INC_DWORD_STAT(STAT_EnemyPoolMisses);
+
+	return EnemyPool::CreateEnemy(GetWorld(), EnemyClass, SpawnTransform);
+}
+
+void UEnemyPoolSubsystem::Release(AEnemy* Enemy)
+{
+	if (!IsValid(Enemy)) return;
+
+	FEnemyPoolBucket& Bucket = Buckets.FindOrAdd(Enemy->GetClass());
+	if (Bucket.FreeEnemies.Num() >= MaxFreePerClass)
+	{
+		Enemy->Destroy();
+		return;
+	}
+
+	Enemy->DeactivatePooledEnemy();
+	Bucket.FreeEnemies.Add(Enemy);
+	INC_DWORD_STAT(STAT_PooledEnemies);
+}
+
+void UEnemyPoolSubsystem::QueueActivation(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform, TFunction<void(AEnemy*)> OnActivated)
+{
+	if (EnemyClass == nullptr) return;
+
+	FEnemyActivation Activation;
+	Activation.EnemyClass = EnemyClass;
+	Activation.Transform = SpawnTransform;
+	Activation.OnActivated = MoveTemp(OnActivated);
+	QueuedActivations.Add(MoveTemp(Activation));
+}
+
+void UEnemyPoolSubsystem::Prewarm(TSubclassOf<AEnemy> EnemyClass, int32 Count)
+{
+	if (EnemyClass == nullptr) return;
+
+	const int32 NumFree{ Buckets.FindOrAdd(EnemyClass.Get()).FreeEnemies.Num() };
+	const int32 NumToCreate{ FMath::Min(Count, MaxFreePerClass) - NumFree };
+	for (int32 i = 0; i < NumToCreate; i++)
+	{
+		//Hidden with collision off straight away, placed for real when first activated
+		Release(EnemyPool::CreateEnemy(GetWorld(), EnemyClass, FTransform::Identity));
+	}
+}
+
+void UEnemyPoolSubsystem::Tick(float DeltaTime)
+{
+	if (QueuedActivations.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_ActivatePooledEnemies);
+
+	//Oldest first, callbacks may queue more so take this frame's share out before running them
+	const int32 NumToActivate{ FMath::Min(MaxActivationsPerFrame, QueuedActivations.Num()) };
+	TArray<FEnemyActivation> Activations;
+	Activations.Reserve(NumToActivate);
+	for (int32 i = 0; i < NumToActivate; i++)
+	{
+		Activations.Add(MoveTemp(QueuedActivations[i]));
+	}
+	QueuedActivations.RemoveAt(0, NumToActivate, false);
+
+	for (FEnemyActivation& Activation : Activations)
+	{
+		AEnemy* Enemy = Acquire(Activation.EnemyClass, Activation.Transform);
+		if (Activation.OnActivated)
+		{
+			Activation.OnActivated(Enemy);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_QueuedEnemyActivations, QueuedActivations.Num());
+}
+
+TStatId UEnemyPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPoolSubsystem, STATGROUP_Tickables);
+}
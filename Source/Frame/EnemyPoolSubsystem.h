@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPoolSubsystem.generated.h"
+
+class AEnemy;
+
+//Deactivated enemies of one class
+USTRUCT()
+struct FEnemyPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AEnemy*> FreeEnemies;
+};
+
+//Enemy waiting for its turn under the activation budget
+struct FEnemyActivation
+{
+	TSubclassOf<AEnemy> EnemyClass;
+	FTransform Transform;
+	TFunction<void(AEnemy*)> OnActivated;
+};
+
+/**
+ * Recycles enemies. Dead enemies are parked hidden with their AI stopped instead of destroyed, and
+ * spawning one of the same class resets health, blackboard, collision and animation on a parked one.
+ * Queued activations are spread across frames so a whole wave does not come alive in one tick.
+ */
+UCLASS()
+class FRAME_API UEnemyPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Spawns through the world's enemy pool right away, or a new actor if there is none
+	static AEnemy* SpawnEnemy(const UObject* WorldContextObject, TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform);
+
+	//Returns the enemy to the world's enemy pool, or destroys it if there is none
+	static void ReleaseEnemy(const UObject* WorldContextObject, AEnemy* Enemy);
+
+	AEnemy* Acquire(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform);
+	void Release(AEnemy* Enemy);
+
+	//Activates on a later frame within the per-frame budget, OnActivated gets the enemy or null if it could not spawn
+	void QueueActivation(TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform, TFunction<void(AEnemy*)> OnActivated = nullptr);
+
+	//Makes sure at least Count deactivated enemies of the class are waiting
+	void Prewarm(TSubclassOf<AEnemy> EnemyClass, int32 Count);
+
+	FORCEINLINE int32 GetNumQueuedActivations() const { return QueuedActivations.Num(); }
+
+	//Number of spawns served from a deactivated enemy
+	UFUNCTION(BlueprintPure, Category = Enemies)
+	int32 GetPoolHits() const { return PoolHits; }
+
+	//Number of spawns that had to create a new actor
+	UFUNCTION(BlueprintPure, Category = Enemies)
+	int32 GetPoolMisses() const { return PoolMisses; }
+
+private:
+
+	UPROPERTY()
+	TMap<UClass*, FEnemyPoolBucket> Buckets;
+
+	TArray<FEnemyActivation> QueuedActivations;
+
+	//Deactivated enemies kept per class - extras are destroyed on release
+	static constexpr int32 MaxFreePerClass{ 64 };
+
+	//Queued activations handled each frame
+	static constexpr int32 MaxActivationsPerFrame{ 2 };
+
+	int32 PoolHits = 0;
+	int32 PoolMisses = 0;
+};
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyRegistrySubsystem.h"
+#include "Enemy.h"
+#include "Frame.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Alive Enemies"), STAT_AliveEnemies, STATGROUP_Frame);
+
+void UEnemyRegistrySubsystem::Deinitialize()
+{
+	AliveEnemies.Empty();
+	AliveTeams.Empty();
+	EnemyIndices.Empty();
+	AliveByTeam.Empty();
+	DeadByTeam.Empty();
+	NumDead = 0;
+	PendingSpawners.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyRegistrySubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || IsRegistered(Enemy)) return;
+
+	const uint8 TeamId{ Enemy->GetTeamId() };
+	EnemyIndices.Add(Enemy, AliveEnemies.Add(Enemy));
+	AliveTeams.Add(TeamId);
+
+	if (!AliveByTeam.IsValidIndex(TeamId))
+	{
+		AliveByTeam.SetNumZeroed(TeamId + 1);
+	}
+	AliveByTeam[TeamId]++;
+
+	SET_DWORD_STAT(STAT_AliveEnemies, AliveEnemies.Num());
+}
+
+void UEnemyRegistrySubsystem::MarkDead(AEnemy* Enemy)
+{
+	RemoveEnemy(Enemy, true);
+}
+
+void UEnemyRegistrySubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	RemoveEnemy(Enemy, false);
+}
+
+void UEnemyRegistrySubsystem::RemoveEnemy(AEnemy* Enemy, bool bCountDeath)
+{
+	int32 Index;
+	if (!EnemyIndices.RemoveAndCopyValue(Enemy, Index)) return;
+
+	const uint8 TeamId{ AliveTeams[Index] };
+	AliveByTeam[TeamId]--;
+	if (bCountDeath)
+	{
+		if (!DeadByTeam.IsValidIndex(TeamId))
+		{
+			DeadByTeam.SetNumZeroed(TeamId + 1);
+		}
+		DeadByTeam[TeamId]++;
+		NumDead++;
+	}
+
+	AliveEnemies.RemoveAtSwap(Index, 1, false);
+	AliveTeams.RemoveAtSwap(Index, 1, false);
+	if (AliveEnemies.IsValidIndex(Index))
+	{
+		EnemyIndices[AliveEnemies[Index]] = Index;
+	}
+
+	SET_DWORD_STAT(STAT_AliveEnemies, AliveEnemies.Num());
+}
+
+int32 UEnemyRegistrySubsystem::GetNumAlive(uint8 TeamId) const
+{
+	return AliveByTeam.IsValidIndex(TeamId) ? AliveByTeam[TeamId] : 0;
+}
+
+int32 UEnemyRegistrySubsystem::GetNumDead(uint8 TeamId) const
+{
+	return DeadByTeam.IsValidIndex(TeamId) ? DeadByTeam[TeamId] : 0;
+}
+
+void UEnemyRegistrySubsystem::SetSpawnsPending(const UObject* Spawner, bool bPending)
+{
+	if (Spawner == nullptr) return;
+
+	if (bPending)
+	{
+		PendingSpawners.Add(Spawner);
+	}
+	else
+	{
+		PendingSpawners.Remove(Spawner);
+	}
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "EnemyRegistrySubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Every live enemy actor in the world, kept in a dense array with alive and dead counts per team.
+ * Enemies register when they start playing or come out of the pool, are marked dead in Die and leave
+ * quietly when parked or destroyed, so win conditions compare counters instead of walking actors.
+ * Spawners with waves still to start register as pending, so the gap between waves is not read as a win.
+ */
+UCLASS()
+class FRAME_API UEnemyRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+
+	//Removes a live enemy and counts it as dead on its team
+	void MarkDead(AEnemy* Enemy);
+
+	//Removes a live enemy without counting a death, for pooling and level unload
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	FORCEINLINE bool IsRegistered(const AEnemy* Enemy) const { return EnemyIndices.Contains(Enemy); }
+
+	//Live enemies in no particular order, safe to iterate but not to modify while doing so
+	FORCEINLINE const TArray<AEnemy*>& GetAliveEnemies() const { return AliveEnemies; }
+
+	FORCEINLINE int32 GetNumAlive() const { return AliveEnemies.Num(); }
+	FORCEINLINE int32 GetNumDead() const { return NumDead; }
+	int32 GetNumAlive(uint8 TeamId) const;
+	int32 GetNumDead(uint8 TeamId) const;
+
+	//Spawner has enemies it has not started spawning yet, cleared once its last wave is under way
+	void SetSpawnsPending(const UObject* Spawner, bool bPending);
+
+	FORCEINLINE bool HasPendingSpawns() const { return PendingSpawners.Num() > 0; }
+
+private:
+
+	//Swaps the last enemy into the hole and updates its index
+	void RemoveEnemy(AEnemy* Enemy, bool bCountDeath);
+
+	UPROPERTY()
+	TArray<AEnemy*> AliveEnemies;
+
+	//Team each entry of AliveEnemies registered with, so leaving uses the same counter
+	TArray<uint8> AliveTeams;
+
+	//Position of each live enemy in AliveEnemies
+	TMap<TObjectKey<AEnemy>, int32> EnemyIndices;
+
+	//Indexed by team id, grown on first use
+	TArray<int32> AliveByTeam;
+	TArray<int32> DeadByTeam;
+
+	int32 NumDead = 0;
+
+	TSet<TObjectKey<UObject>> PendingSpawners;
+};
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemySignificanceSettings.h"
+
+namespace
+{
+	FEnemySignificanceBucket MakeBucket(float MaxDistance, float ActorTickInterval, int32 AnimUpdateRate, float BehaviorTickInterval)
+	{
+		FEnemySignificanceBucket Bucket;
+		Bucket.MaxDistance = MaxDistance;
+		Bucket.ActorTickInterval = ActorTickInterval;
+		Bucket.AnimUpdateRate = AnimUpdateRate;
+		Bucket.BehaviorTickInterval = BehaviorTickInterval;
+		return Bucket;
+	}
+}
+
+UEnemySignificanceSettings::UEnemySignificanceSettings() :
+	bEnabled(true),
+	UpdateInterval(0.25f),
+	OffScreenBucketDrop(1),
+	OffScreenTolerance(0.25f),
+	CombatBucket(0)
+{
+	//Fighting or close, near, mid range, far or hidden
+	Buckets.Add(MakeBucket(1500.f, 0.f, 1, 0.f));
+	Buckets.Add(MakeBucket(3000.f, 0.05f, 2, 0.1f));
+	Buckets.Add(MakeBucket(6000.f, 0.15f, 4, 0.25f));
+	Buckets.Add(MakeBucket(0.f, 0.5f, 8, 0.5f));
+}
+
+int32 UEnemySignificanceSettings::GetDistanceBucket(float Distance) const
+{
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num() - 1; BucketIndex++)
+	{
+		if (Distance <= Buckets[BucketIndex].MaxDistance) return BucketIndex;
+	}
+	return FMath::Max(Buckets.Num() - 1, 0);
+}
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "EnemySignificanceSettings.generated.h"
+
+//How often an enemy in one significance bucket ticks, animates and thinks
+USTRUCT(BlueprintType)
+struct FEnemySignificanceBucket
+{
+	GENERATED_BODY()
+
+	//On screen enemies closer than this to a player's view fall in this bucket or a nearer one
+	UPROPERTY(EditAnywhere, Category = Significance, meta = (ClampMin = "0.0"))
+	float MaxDistance = 0.f;
+
+	//Seconds between actor ticks, 0 ticks every frame
+	UPROPERTY(EditAnywhere, Category = Significance, meta = (ClampMin = "0.0"))
+	float ActorTickInterval = 0.f;
+
+	//Frames between animation updates, 1 updates every frame
+	UPROPERTY(EditAnywhere, Category = Significance, meta = (ClampMin = "1"))
+	int32 AnimUpdateRate = 1;
+
+	//Seconds between behavior tree ticks, 0 ticks every frame
+	UPROPERTY(EditAnywhere, Category = Significance, meta = (ClampMin = "0.0"))
+	float BehaviorTickInterval = 0.f;
+};
+
+/**
+ * Buckets and thresholds the enemy significance subsystem sorts enemies with, editable under
+ * Project Settings > Game > Enemy Significance and saved to DefaultGame.ini.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Enemy Significance"))
+class FRAME_API UEnemySignificanceSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UEnemySignificanceSettings();
+
+	virtual FName GetCategoryName() const override { return FName("Game"); }
+
+	//Bucket for an enemy at a distance, before screen and combat adjustments
+	int32 GetDistanceBucket(float Distance) const;
+
+	//Turn off to tick every enemy at full rate, for comparing costs
+	UPROPERTY(Config, EditAnywhere, Category = Significance)
+	bool bEnabled;
+
+	//Seconds between significance passes
+	UPROPERTY(Config, EditAnywhere, Category = Significance, meta = (ClampMin = "0.0"))
+	float UpdateInterval;
+
+	//Nearest first, the last bucket also takes everything further out
+	UPROPERTY(Config, EditAnywhere, Category = Significance)
+	TArray<FEnemySignificanceBucket> Buckets;
+
+	//Buckets an enemy drops when it has not been rendered recently
+	UPROPERTY(Config, EditAnywhere, Category = Significance, meta = (ClampMin = "0"))
+	int32 OffScreenBucketDrop;
+
+	//Seconds since last render before an enemy counts as off screen
+	UPROPERTY(Config, EditAnywhere, Category = Significance, meta = (ClampMin = "0.0"))
+	float OffScreenTolerance;
+
+	//Least significant bucket an enemy fighting a player can fall into, see AEnemy::IsInCombat
+	UPROPERTY(Config, EditAnywhere, Category = Significance, meta = (ClampMin = "0"))
+	int32 CombatBucket;
+};
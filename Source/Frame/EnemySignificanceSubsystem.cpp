@@ -0,0 +1,298 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemySignificanceSubsystem.h"
+#include "AIController.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "EnemySignificanceSettings.h"
+#include "Enemy.h"
+#include "ThrottledBehaviorTreeComponent.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Enemy Significance"), STAT_UpdateEnemySignificance, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Enemies"), STAT_SignificanceEnemies, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Full Rate"), STAT_SignificanceFullRate, STATGROUP_Frame);
+
+UEnemySignificanceSubsystem::UEnemySignificanceSubsystem() :
+	TimeSinceUpdate(0.f)
+{
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	Enemies.Empty();
+	BucketCounts.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr) return;
+
+	FEnemySignificanceEntry Entry;
+	Entry.Enemy = Enemy;
+	Enemies.Add(Entry);
+
+	//Sorted on the next pass, until then it runs at full rate
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	Enemies.RemoveAllSwap([Enemy](const FEnemySignificanceEntry& Entry) { return Entry.Enemy == Enemy; });
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < GetDefault<UEnemySignificanceSettings>()->UpdateInterval) return;
+	TimeSinceUpdate = 0.f;
+
+	UpdateSignificance();
+}
+
+void UEnemySignificanceSubsystem::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UpdateEnemySignificance);
+
+	const UEnemySignificanceSettings* Settings = GetDefault<UEnemySignificanceSettings>();
+	const bool bEnabled{ Settings->bEnabled && Settings->Buckets.Num() > 0 };
+
+	//Every local and remote player's camera counts as a view
+	TArray<FVector> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ViewLocations.Add(ViewLocation);
+	}
+
+	BucketCounts.Init(0, Settings->Buckets.Num());
+
+	for (int32 EntryIndex = Enemies.Num() - 1; EntryIndex >= 0; EntryIndex--)
+	{
+		FEnemySignificanceEntry& Entry = Enemies[EntryIndex];
+		AEnemy* Enemy = Entry.Enemy.Get();
+		if (Enemy == nullptr)
+		{
+			Enemies.RemoveAtSwap(EntryIndex);
+			continue;
+		}
+
+		if (!bEnabled || ViewLocations.Num() == 0)
+		{
+			if (Entry.Bucket != INDEX_NONE)
+			{
+				ApplyFullRate(Enemy);
+				Entry.Bucket = INDEX_NONE;
+			}
+			continue;
+		}
+
+		const int32 Bucket{ GetBucket(Enemy, ViewLocations) };
+		BucketCounts[Bucket]++;
+
+		//Only touch tick functions when the bucket actually changed
+		if (Bucket != Entry.Bucket)
+		{
+			ApplyBucket(Enemy, Settings->Buckets[Bucket]);
+			Entry.Bucket = Bucket;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_SignificanceEnemies, Enemies.Num());
+	SET_DWORD_STAT(STAT_SignificanceFullRate, BucketCounts.Num() > 0 ? BucketCounts[0] : Enemies.Num());
+}
+
+int32 UEnemySignificanceSubsystem::GetBucket(const AEnemy* Enemy, const TArray<FVector>& ViewLocations) const
+{
+	const UEnemySignificanceSettings* Settings = GetDefault<UEnemySignificanceSettings>();
+	const FVector EnemyLocation{ Enemy->GetActorLocation() };
+
+	float ClosestDistanceSquared{ TNumericLimits<float>::Max() };
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(ViewLocation, EnemyLocation));
+	}
+
+	int32 Bucket{ Settings->GetDistanceBucket(FMath::Sqrt(ClosestDistanceSquared)) };
+	if (!Enemy->WasRecentlyRendered(Settings->OffScreenTolerance))
+	{
+		Bucket += Settings->OffScreenBucketDrop;
+	}
+	Bucket = FMath::Min(Bucket, Settings->Buckets.Num() - 1);
+
+	if (Enemy->IsInCombat())
+	{
+		Bucket = FMath::Min(Bucket, Settings->CombatBucket);
+	}
+	return Bucket;
+}
+
+void UEnemySignificanceSubsystem::ApplyBucket(AEnemy* Enemy, const FEnemySignificanceBucket& Bucket)
+{
+	Enemy->SetActorTickInterval(Bucket.ActorTickInterval);
+
+	//URO picks the rate from the LOD map when rendered and the base rate when not, the bucket already covers both
+	USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+	FAnimUpdateRateParameters* UpdateRateParams = Mesh ? Mesh->AnimUpdateRateParams : nullptr;
+	if (UpdateRateParams)
+	{
+		const int32 FrameSkip{ FMath::Max(Bucket.AnimUpdateRate, 1) - 1 };
+		UpdateRateParams->bShouldUseLodMap = true;
+		UpdateRateParams->LODToFrameSkipMap.Reset();
+		for (int32 LODIndex = 0; LODIndex < FMath::Max(Mesh->GetNumLODs(), 1); LODIndex++)
+		{
+			UpdateRateParams->LODToFrameSkipMap.Add(LODIndex, FrameSkip);
+		}
+		UpdateRateParams->BaseNonRenderedUpdateRate = FrameSkip + 1;
+	}
+
+	//The tree reschedules its own tick interval, so it is clamped to the bucket's rather than set once
+	const AAIController* AIController = Cast<AAIController>(Enemy->GetController());
+	UThrottledBehaviorTreeComponent* BehaviorTree = AIController ? Cast<UThrottledBehaviorTreeComponent>(AIController->GetBrainComponent()) : nullptr;
+	if (BehaviorTree)
+	{
+		BehaviorTree->SetMinTickInterval(Bucket.BehaviorTickInterval);
+	}
+}
+
+void UEnemySignificanceSubsystem::ApplyFullRate(AEnemy* Enemy)
+{
+	FEnemySignificanceBucket FullRate;
+	ApplyBucket(Enemy, FullRate);
+
+	//Hand the mesh back to the engine's own screen size based rates
+	USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+	if (Mesh && Mesh->AnimUpdateRateParams)
+	{
+		const FAnimUpdateRateParameters Defaults;
+		Mesh->AnimUpdateRateParams->bShouldUseLodMap = Defaults.bShouldUseLodMap;
+		Mesh->AnimUpdateRateParams->LODToFrameSkipMap.Reset();
+		Mesh->AnimUpdateRateParams->BaseNonRenderedUpdateRate = Defaults.BaseNonRenderedUpdateRate;
+	}
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+namespace EnemySignificanceStress
+{
+	constexpr int32 DefaultEnemyCount{ 200 };
+	//Long enough for every tree to have ticked and rescheduled itself a few times
+	constexpr float BehaviorCheckDelay{ 2.f };
+
+	//Logs how many running behavior trees still tick no faster than their bucket allows
+	void CheckBehaviorTickIntervals(TWeakObjectPtr<UWorld> WeakWorld)
+	{
+		UWorld* World = WeakWorld.Get();
+		if (World == nullptr) return;
+
+		int32 NumThrottled{ 0 };
+		int32 NumHeld{ 0 };
+		int32 NumOverridden{ 0 };
+		for (TActorIterator<AEnemy> It(World); It; ++It)
+		{
+			const AAIController* AIController = Cast<AAIController>(It->GetController());
+			const UThrottledBehaviorTreeComponent* BehaviorTree = AIController ? Cast<UThrottledBehaviorTreeComponent>(AIController->GetBrainComponent()) : nullptr;
+			if (BehaviorTree == nullptr || BehaviorTree->GetMinTickInterval() <= 0.f) continue;
+
+			NumThrottled++;
+			if (!BehaviorTree->IsComponentTickEnabled() || BehaviorTree->GetComponentTickInterval() >= BehaviorTree->GetMinTickInterval())
+			{
+				NumHeld++;
+			}
+			else
+			{
+				NumOverridden++;
+			}
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("Enemy significance stress: %.1f s later, %d throttled behavior trees, %d holding their bucket interval, %d ticking faster"),
+			BehaviorCheckDelay, NumThrottled, NumHeld, NumOverridden);
+	}
+
+	//Spawns enemies out past the furthest bucket around the first player and logs how they sorted
+	void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		UEnemySignificanceSubsystem* Significance = World ? World->GetSubsystem<UEnemySignificanceSubsystem>() : nullptr;
+		const APawn* Pawn = UGameplayStatics::GetPlayerPawn(World, 0);
+		if (Significance == nullptr || Pawn == nullptr) return;
+
+		const int32 EnemyCount{ Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : DefaultEnemyCount };
+
+		//Given class, or the class of an enemy already in the level
+		UClass* EnemyClass{ nullptr };
+		if (Args.Num() > 1)
+		{
+			EnemyClass = LoadClass<AEnemy>(nullptr, *Args[1]);
+		}
+		else
+		{
+			TActorIterator<AEnemy> It(World);
+			EnemyClass = It ? It->GetClass() : nullptr;
+		}
+		if (EnemyClass == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Enemy significance stress: no enemy class to spawn"));
+			return;
+		}
+
+		float Radius{ 0.f };
+		for (const FEnemySignificanceBucket& Bucket : GetDefault<UEnemySignificanceSettings>()->Buckets)
+		{
+			Radius = FMath::Max(Radius, Bucket.MaxDistance);
+		}
+		Radius = FMath::Max(Radius * 1.25f, 1000.f);
+
+		const FVector Center{ Pawn->GetActorLocation() };
+		int32 NumSpawned{ 0 };
+		for (int32 i = 0; i < EnemyCount; i++)
+		{
+			const FVector2D Offset{ FMath::RandPointInCircle(Radius) };
+			const FTransform SpawnTransform{ FRotator(0.f, FMath::FRandRange(0.f, 360.f), 0.f), Center + FVector(Offset, 0.f) };
+
+			//Deferred so the controller exists before BeginPlay starts the behavior tree
+			AEnemy* Enemy = World->SpawnActorDeferred<AEnemy>(EnemyClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+			if (Enemy == nullptr) continue;
+
+			Enemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+			UGameplayStatics::FinishSpawningActor(Enemy, SpawnTransform);
+			NumSpawned++;
+		}
+
+		const double StartTime{ FPlatformTime::Seconds() };
+		Significance->UpdateSignificance();
+		const double PassMs{ (FPlatformTime::Seconds() - StartTime) * 1000.0 };
+
+		FString Counts;
+		const TArray<int32>& BucketCounts = Significance->GetBucketCounts();
+		for (int32 BucketIndex = 0; BucketIndex < BucketCounts.Num(); BucketIndex++)
+		{
+			Counts += FString::Printf(TEXT(" [%d] %d"), BucketIndex, BucketCounts[BucketIndex]);
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("Enemy significance stress: spawned %d, tracking %d, pass %.3f ms, buckets%s"),
+			NumSpawned, Significance->GetNumEnemies(), PassMs, *Counts);
+		UE_LOG(LogTemp, Log, TEXT("Compare 'stat Game' and 'stat Anim' with Enemy Significance enabled and disabled in Project Settings"));
+
+		//Trees reschedule their own tick after running, so the intervals are only meaningful once they have
+		FTimerHandle CheckTimer;
+		World->GetTimerManager().SetTimer(CheckTimer, FTimerDelegate::CreateStatic(&CheckBehaviorTickIntervals, TWeakObjectPtr<UWorld>(World)), BehaviorCheckDelay, false);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs EnemySignificanceStressCommand(
+	TEXT("Frame.EnemySignificanceStress"),
+	TEXT("Spawns enemies around the player and logs their significance buckets. Optional enemy count (default 200) and enemy class path."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&EnemySignificanceStress::Run));
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+struct FEnemySignificanceBucket;
+
+//Enemy tracked by the significance pass and the bucket last applied to it
+struct FEnemySignificanceEntry
+{
+	TWeakObjectPtr<AEnemy> Enemy;
+	int32 Bucket = INDEX_NONE;
+};
+
+/**
+ * Sorts enemies into the buckets of UEnemySignificanceSettings by distance to the nearest player view,
+ * whether they were rendered recently and whether they are fighting. Each bucket sets the actor tick
+ * interval, the mesh's animation update rate and the behavior tree tick interval, so enemies nobody
+ * is looking at or fighting stop costing a full frame of game thread time.
+ */
+UCLASS()
+class FRAME_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemySignificanceSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	//Sorts and applies every enemy now instead of waiting for the next pass
+	void UpdateSignificance();
+
+	//Enemies per bucket after the last pass
+	FORCEINLINE const TArray<int32>& GetBucketCounts() const { return BucketCounts; }
+	FORCEINLINE int32 GetNumEnemies() const { return Enemies.Num(); }
+
+private:
+
+	int32 GetBucket(const AEnemy* Enemy, const TArray<FVector>& ViewLocations) const;
+
+	//Pushes a bucket's rates onto the enemy, its mesh and its behavior tree
+	static void ApplyBucket(AEnemy* Enemy, const FEnemySignificanceBucket& Bucket);
+
+	//Puts an enemy back to full rate when it leaves the subsystem or significance is turned off
+	static void ApplyFullRate(AEnemy* Enemy);
+
+	TArray<FEnemySignificanceEntry> Enemies;
+
+	TArray<int32> BucketCounts;
+
+	float TimeSinceUpdate;
+};
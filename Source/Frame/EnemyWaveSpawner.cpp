@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyWaveSpawner.h"
+#include "NavigationSystem.h"
+#include "Enemy.h"
+#include "EnemyPoolSubsystem.h"
+#include "HordeSubsystem.h"
+#include "HordeSettings.h"
+#include "EnemyRegistrySubsystem.h"
+
+AEnemyWaveSpawner::AEnemyWaveSpawner() :
+	SpawnRadius(1500.f),
+	bStartOnBeginPlay(true),
+	bLoopWaves(false),
+	bSpawnAsHorde(false),
+	CurrentWave(INDEX_NONE),
+	PendingActivations(0)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+}
+
+void AEnemyWaveSpawner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	PrewarmPool();
+
+	UHordeSubsystem* Horde = GetWorld()->GetSubsystem<UHordeSubsystem>();
+	if (bSpawnAsHorde && Horde)
+	{
+		Horde->OnHordeEnemyKilled.AddUObject(this, &AEnemyWaveSpawner::OnHordeEnemyKilled);
+	}
+
+	if (bStartOnBeginPlay && Waves.Num() > 0)
+	{
+		GetWorldTimerManager().SetTimer(NextWaveTimer, this, &AEnemyWaveSpawner::StartNextWave, FMath::Max(Waves[0].StartDelay, KINDA_SMALL_NUMBER));
+	}
+	UpdateSpawnsPending();
+}
+
+void AEnemyWaveSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UEnemyRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UEnemyRegistrySubsystem>();
+	if (Registry)
+	{
+		Registry->SetSpawnsPending(this, false);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemyWaveSpawner::UpdateSpawnsPending()
+{
+	UEnemyRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UEnemyRegistrySubsystem>();
+	if (Registry == nullptr) return;
+
+	//A spawner left for Blueprint to start holds nothing up until it has been started
+	const bool bStarted{ bStartOnBeginPlay || CurrentWave != INDEX_NONE };
+	const bool bWavesLeft{ bLoopWaves ? Waves.Num() > 0 : Waves.IsValidIndex(CurrentWave + 1) };
+	Registry->SetSpawnsPending(this, bStarted && bWavesLeft);
+}
+
+void AEnemyWaveSpawner::PrewarmPool()
+{
+	UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	if (EnemyPool == nullptr) return;
+
+	TMap<UClass*, int32> LargestCounts;
+	for (const FEnemyWave& Wave : Waves)
+	{
+		TMap<UClass*, int32> WaveCounts;
+		for (const FEnemyWaveEntry& Entry : Wave.Enemies)
+		{
+			if (Entry.EnemyClass)
+			{
+				WaveCounts.FindOrAdd(Entry.EnemyClass.Get()) += Entry.Count;
+			}
+		}
+		for (const TPair<UClass*, int32>& WaveCount : WaveCounts)
+		{
+			int32& LargestCount = LargestCounts.FindOrAdd(WaveCount.Key);
+			LargestCount = FMath::Max(LargestCount, WaveCount.Value);
+		}
+	}
+
+	//Horde classes only become actors when promoted, which never exceeds the promoted cap
+	const int32 MaxPromotedEnemies{ GetDefault<UHordeSettings>()->MaxPromotedEnemies };
+	for (const TPair<UClass*, int32>& LargestCount : LargestCounts)
+	{
+		const bool bHordeClass{ bSpawnAsHorde && LargestCount.Key->GetDefaultObject<AEnemy>()->GetHordeMesh() != nullptr };
+		EnemyPool->Prewarm(LargestCount.Key, bHordeClass ? FMath::Min(LargestCount.Value, MaxPromotedEnemies) : LargestCount.Value);
+	}
+}
+
+void AEnemyWaveSpawner::StartNextWave()
+{
+	if (Waves.Num() == 0) return;
+
+	CurrentWave++;
+	if (CurrentWave >= Waves.Num())
+	{
+		if (!bLoopWaves) return;
+		CurrentWave = 0;
+	}
+	//This wave's enemies count through the pool queue, horde and registry from here on
+	UpdateSpawnsPending();
+
+	UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	UHordeSubsystem* Horde = bSpawnAsHorde ? GetWorld()->GetSubsystem<UHordeSubsystem>() : nullptr;
+	for (const FEnemyWaveEntry& Entry : Waves[CurrentWave].Enemies)
+	{
+		for (int32 i = 0; i < Entry.Count; i++)
+		{
+			//Classes without a horde mesh fall through to the pool
+			if (Horde && Horde->AddEntity(Entry.EnemyClass, GetSpawnLocation(), this)) continue;
+
+			const FTransform SpawnTransform{ FRotator(0.f, FMath::FRandRange(0.f, 360.f), 0.f), GetSpawnLocation() };
+			if (EnemyPool)
+			{
+				PendingActivations++;
+				TWeakObjectPtr<AEnemyWaveSpawner> WeakThis(this);
+				EnemyPool->QueueActivation(Entry.EnemyClass, SpawnTransform, [WeakThis](AEnemy* Enemy)
+				{
+					if (WeakThis.IsValid())
+					{
+						WeakThis->OnEnemyActivated(Enemy);
+					}
+				});
+			}
+			else
+			{
+				PendingActivations++;
+				OnEnemyActivated(UEnemyPoolSubsystem::SpawnEnemy(this, Entry.EnemyClass, SpawnTransform));
+			}
+		}
+	}
+
+	CheckWaveCleared();
+}
+
+FVector AEnemyWaveSpawner::GetSpawnLocation() const
+{
+	const FVector Origin{ GetActorLocation() };
+
+	UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	FNavLocation NavLocation;
+	if (NavigationSystem && NavigationSystem->GetRandomReachablePointInRadius(Origin, SpawnRadius, NavLocation))
+	{
+		return NavLocation.Location;
+	}
+	return Origin + FVector(FMath::RandPointInCircle(SpawnRadius), 0.f);
+}
+
+void AEnemyWaveSpawner::OnEnemyActivated(AEnemy* Enemy)
+{
+	PendingActivations--;
+	if (Enemy)
+	{
+		AliveEnemies.Add(Enemy);
+		Enemy->OnEnemyDied.AddUObject(this, &AEnemyWaveSpawner::OnEnemyDied);
+	}
+	CheckWaveCleared();
+}
+
+void AEnemyWaveSpawner::OnEnemyDied(AEnemy* Enemy)
+{
+	AliveEnemies.Remove(Enemy);
+	CheckWaveCleared();
+}
+
+void AEnemyWaveSpawner::OnHordeEnemyKilled(AActor* Owner, AEnemy* Enemy)
+{
+	if (Owner == this)
+	{
+		CheckWaveCleared();
+	}
+}
+
+int32 AEnemyWaveSpawner::GetNumHordeEnemies() const
+{
+	const UWorld* World = GetWorld();
+	const UHordeSubsystem* Horde = World ? World->GetSubsystem<UHordeSubsystem>() : nullptr;
+	return Horde ? Horde->GetNumEntities(this) : 0;
+}
+
+void AEnemyWaveSpawner::CheckWaveCleared()
+{
+	//Enemies destroyed rather than killed do not hold the wave up
+	AliveEnemies.RemoveAllSwap([](const TWeakObjectPtr<AEnemy>& Enemy) { return !Enemy.IsValid(); });
+	if (AliveEnemies.Num() > 0 || PendingActivations > 0 || GetNumHordeEnemies() > 0 || GetWorldTimerManager().IsTimerActive(NextWaveTimer)) return;
+
+	const int32 NextWave{ CurrentWave + 1 };
+	if (!Waves.IsValidIndex(NextWave) && !bLoopWaves) return;
+
+	const float StartDelay{ Waves.IsValidIndex(NextWave) ? Waves[NextWave].StartDelay : Waves[0].StartDelay };
+	GetWorldTimerManager().SetTimer(NextWaveTimer, this, &AEnemyWaveSpawner::StartNextWave, FMath::Max(StartDelay, KINDA_SMALL_NUMBER));
+}
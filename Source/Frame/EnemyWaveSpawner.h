@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EnemyWaveSpawner.generated.h"
+
+class AEnemy;
+
+USTRUCT(BlueprintType)
+struct FEnemyWaveEntry
+{
+	GENERATED_BODY()
+
+	//BP_MinionMelee, BP_MinionDawn, BP_EnemyCrunch or any other enemy class
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave)
+	TSubclassOf<AEnemy> EnemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave, meta = (ClampMin = "0"))
+	int32 Count = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FEnemyWave
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave)
+	TArray<FEnemyWaveEntry> Enemies;
+
+	//Seconds after the previous wave is cleared before this one starts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave, meta = (ClampMin = "0.0"))
+	float StartDelay = 3.f;
+};
+
+/**
+ * Spawns waves of enemies around itself through the enemy pool. Every class used by any wave is
+ * prewarmed in BeginPlay while the level loads, and each wave is queued as budgeted activations
+ * so enemies come alive a few per frame. The next wave starts once every enemy of the current one has died.
+ * With bSpawnAsHorde, classes that have a horde mesh join the horde subsystem as entities instead.
+ */
+UCLASS()
+class FRAME_API AEnemyWaveSpawner : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	AEnemyWaveSpawner();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UFUNCTION(BlueprintCallable)
+	void StartNextWave();
+
+	//Prewarms enough of each class for the largest wave that uses it
+	void PrewarmPool();
+
+	//Random navigable point within SpawnRadius, or a random point if there is no navmesh
+	FVector GetSpawnLocation() const;
+
+	void OnEnemyActivated(AEnemy* Enemy);
+	void OnEnemyDied(AEnemy* Enemy);
+	void OnHordeEnemyKilled(AActor* Owner, AEnemy* Enemy);
+
+	//Starts the next wave's delay once nothing of this wave is alive or waiting to activate
+	void CheckWaveCleared();
+
+	//Entities and promoted enemies this spawner added to the horde
+	int32 GetNumHordeEnemies() const;
+
+	//Tells the enemy registry whether waves are still to come, so win checks wait for them
+	void UpdateSpawnsPending();
+
+private:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave, meta = (AllowPrivateAccess = "true"))
+	TArray<FEnemyWave> Waves;
+
+	//Enemies appear within this distance of the spawner
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave, meta = (AllowPrivateAccess = "true"))
+	float SpawnRadius;
+
+	//Starts the first wave on BeginPlay, otherwise wait for StartNextWave
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave, meta = (AllowPrivateAccess = "true"))
+	bool bStartOnBeginPlay;
+
+	//Starts again from the first wave after the last is cleared
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave, meta = (AllowPrivateAccess = "true"))
+	bool bLoopWaves;
+
+	//Adds enemies as horde entities that only become actors near a player, for waves too large to run as actors
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave, meta = (AllowPrivateAccess = "true"))
+	bool bSpawnAsHorde;
+
+	//Index of the wave running now, INDEX_NONE before the first
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Wave, meta = (AllowPrivateAccess = "true"))
+	int32 CurrentWave;
+
+	//Enemies of the current wave still queued in the enemy pool
+	int32 PendingActivations;
+
+	TArray<TWeakObjectPtr<AEnemy>> AliveEnemies;
+
+	FTimerHandle NextWaveTimer;
+
+public:
+	FORCEINLINE int32 GetCurrentWave() const { return CurrentWave; }
+	FORCEINLINE int32 GetNumAliveEnemies() const { return AliveEnemies.Num() + GetNumHordeEnemies(); }
+};
@@ -7,7 +7,9 @@
 #include "Particles/ParticleSystemComponent.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/Character.h"
-#include "Kismet/GameplayStatics.h"
+#include "WorldCollision.h"
+#include "DamageQueueSubsystem.h"
+#include "HordeSubsystem.h"
 
 // Sets default values
 AExplosive::AExplosive() :
@@ -49,19 +51,38 @@ void AExplosive::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter,
 		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplodeParticles, HitResult.Location, FRotator(0.f), true);
 	}
 	// Applying explosive damage
-	TArray<AActor*> OverlappingActors;
-	GetOverlappingActors(OverlappingActors, ACharacter::StaticClass());
+	ApplyExplosionDamage(this, GetActorLocation(), OverlapSphere->GetScaledSphereRadius(), Damage, Shooter, FrameController);
 
-	for (auto Actor : OverlappingActors)
-	{
-		
-		UE_LOG(LogTemp, Warning, TEXT("Actor damaged by explosive: %s"), *Actor->GetName());
-		UGameplayStatics::ApplyDamage(Actor, Damage, FrameController, Shooter, UDamageType::StaticClass());
-	}
+	Destroy();
 
+}
 
-	Destroy();
+void AExplosive::ApplyExplosionDamage(const UObject* WorldContextObject, const FVector& Origin, float Radius, float Damage, AActor* DamageCauser, AController* InstigatorController)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (World == nullptr || Radius <= 0.f) return;
 
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByObjectType(Overlaps, Origin, FQuat::Identity, FCollisionObjectQueryParams(ECollisionChannel::ECC_Pawn), FCollisionShape::MakeSphere(Radius));
+
+	// Characters overlap with capsule and mesh, damage each once
+	TArray<AActor*, TInlineAllocator<16>> DamagedActors;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		ACharacter* Character = Cast<ACharacter>(Overlap.GetActor());
+		if (Character == nullptr || DamagedActors.Contains(Character)) continue;
+		DamagedActors.Add(Character);
+
+		UE_LOG(LogTemp, Verbose, TEXT("Actor damaged by explosive: %s"), *Character->GetName());
+		UDamageQueueSubsystem::QueueDamage(World, Character, Damage, InstigatorController, DamageCauser);
+	}
+
+	// Horde entities have no bodies for the overlap to find
+	UHordeSubsystem* Horde = World->GetSubsystem<UHordeSubsystem>();
+	if (Horde)
+	{
+		Horde->DamageEntitiesInRadius(Origin, Radius, Damage);
+	}
 }
 
 
@@ -47,4 +47,7 @@ public:
 
 	virtual void BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* FrameController) override;
 
+	//Damages every character within Radius of Origin - shared by explosives and rockets
+	static void ApplyExplosionDamage(const UObject* WorldContextObject, const FVector& Origin, float Radius, float Damage, AActor* DamageCauser, AController* InstigatorController);
+
 };
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FXPoolSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "FrameDataRegistry.h"
+#include "Frame.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("FX Pool Hits"), STAT_FXPoolHits, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("FX Pool Misses"), STAT_FXPoolMisses, STATGROUP_Frame);
+
+void UFXPoolSubsystem::Deinitialize()
+{
+	for (auto& BucketPair : Buckets)
+	{
+		for (UParticleSystemComponent* Component : BucketPair.Value.FreeComponents)
+		{
+			if (IsValid(Component))
+			{
+				Component->DestroyComponent();
+			}
+		}
+	}
+	Buckets.Empty();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UFXPoolSubsystem::SpawnEmitter(const UObject* WorldContextObject, UParticleSystem* Template, const FTransform& SpawnTransform)
+{
+	if (Template == nullptr || WorldContextObject == nullptr) return nullptr;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	UFXPoolSubsystem* FXPool = World ? World->GetSubsystem<UFXPoolSubsystem>() : nullptr;
+	if (FXPool)
+	{
+		return FXPool->Acquire(Template, SpawnTransform);
+	}
+	return UGameplayStatics::SpawnEmitterAtLocation(WorldContextObject, Template, SpawnTransform);
+}
+
+UParticleSystemComponent* UFXPoolSubsystem::SpawnEmitter(const UObject* WorldContextObject, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	return SpawnEmitter(WorldContextObject, Template, FTransform(Rotation, Location));
+}
+
+UParticleSystemComponent* UFXPoolSubsystem::Acquire(UParticleSystem* Template, const FTransform& SpawnTransform)
+{
+	if (Template == nullptr) return nullptr;
+
+	FFXPoolBucket& Bucket = Buckets.FindOrAdd(Template);
+	while (Bucket.FreeComponents.Num() > 0)
+	{
+		UParticleSystemComponent* Component = Bucket.FreeComponents.Pop(false);
+		if (!IsValid(Component))
+		{
+			Bucket.NumCreated--;
+			continue;
+		}
+
+		//Move and restart finished component
+		Component->SetWorldTransform(SpawnTransform);
+		Component->ActivateSystem(true);
+
+		PoolHits++;
+		INC_DWORD_STAT(STAT_FXPoolHits);
+		return Component;
+	}
+
+	PoolMisses++;
+	INC_DWORD_STAT(STAT_FXPoolMisses);
+	return CreateComponent(Template, SpawnTransform, true);
+}
+
+void UFXPoolSubsystem::Prewarm(UParticleSystem* Template, int32 Count)
+{
+	if (Template == nullptr) return;
+
+	const int32 NumCreated = Buckets.FindOrAdd(Template).NumCreated;
+	for (int32 i = NumCreated; i < Count; i++)
+	{
+		UParticleSystemComponent* Component = CreateComponent(Template, FTransform::Identity, false);
+		if (Component)
+		{
+			Buckets.FindChecked(Template).FreeComponents.Add(Component);
+		}
+	}
+}
+
+void UFXPoolSubsystem::PrewarmWeaponEffects(int32 Count)
+{
+	const FFrameDataTables& DataTables = UFrameDataRegistry::GetDataTables(this);
+	for (int32 Type = 0; Type < static_cast<int32>(EWeaponType::EWT_MAX); Type++)
+	{
+		const FWeaponDataTable* WeaponRow = DataTables.GetWeaponData(static_cast<EWeaponType>(Type));
+		if (WeaponRow)
+		{
+			Prewarm(WeaponRow->MuzzleFlash, Count);
+		}
+	}
+}
+
+UParticleSystemComponent* UFXPoolSubsystem::CreateComponent(UParticleSystem* Template, const FTransform& SpawnTransform, bool bActivate)
+{
+	//Not auto destroyed - returned to the pool when finished instead
+	UParticleSystemComponent* Component = UGameplayStatics::SpawnEmitterAtLocation(
+		GetWorld(), Template, SpawnTransform, false, EPSCPoolMethod::None, bActivate);
+
+	if (Component)
+	{
+		Component->OnSystemFinished.AddDynamic(this, &UFXPoolSubsystem::OnPooledSystemFinished);
+		Buckets.FindOrAdd(Template).NumCreated++;
+	}
+	return Component;
+}
+
+void UFXPoolSubsystem::OnPooledSystemFinished(UParticleSystemComponent* PSystem)
+{
+	if (PSystem == nullptr) return;
+
+	FFXPoolBucket* Bucket = Buckets.Find(PSystem->Template);
+	if (Bucket == nullptr) return;
+
+	if (Bucket->FreeComponents.Num() < MaxFreePerTemplate)
+	{
+		Bucket->FreeComponents.Add(PSystem);
+	}
+	else
+	{
+		Bucket->NumCreated--;
+		PSystem->OnSystemFinished.RemoveAll(this);
+		PSystem->DestroyComponent();
+	}
+}
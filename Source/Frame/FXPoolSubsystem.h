@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FXPoolSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+//Components created for one particle system template
+USTRUCT()
+struct FFXPoolBucket
+{
+	GENERATED_BODY()
+
+	//Finished components ready to be reactivated
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> FreeComponents;
+
+	//Components created for this template, free or playing
+	int32 NumCreated = 0;
+};
+
+/**
+ * Recycles particle system components for frequently spawned one-shot effects
+ * (muzzle flash, bullet beams, impacts) instead of creating a new component per shot.
+ */
+UCLASS()
+class FRAME_API UFXPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	//Spawns through the world's FX pool, or a regular emitter if there is none
+	static UParticleSystemComponent* SpawnEmitter(const UObject* WorldContextObject, UParticleSystem* Template, const FTransform& SpawnTransform);
+	static UParticleSystemComponent* SpawnEmitter(const UObject* WorldContextObject, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+	//Plays template at transform, reusing a finished component when one is free
+	UParticleSystemComponent* Acquire(UParticleSystem* Template, const FTransform& SpawnTransform);
+
+	//Makes sure at least Count components exist for template
+	void Prewarm(UParticleSystem* Template, int32 Count);
+
+	//Prewarms the muzzle flash of every weapon type
+	void PrewarmWeaponEffects(int32 Count);
+
+	//Number of spawns served from a free component
+	UFUNCTION(BlueprintPure, Category = FX)
+	int32 GetPoolHits() const { return PoolHits; }
+
+	//Number of spawns that had to create a new component
+	UFUNCTION(BlueprintPure, Category = FX)
+	int32 GetPoolMisses() const { return PoolMisses; }
+
+private:
+
+	UParticleSystemComponent* CreateComponent(UParticleSystem* Template, const FTransform& SpawnTransform, bool bActivate);
+
+	//Returns components to their bucket once the effect has played out
+	UFUNCTION()
+	void OnPooledSystemFinished(UParticleSystemComponent* PSystem);
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FFXPoolBucket> Buckets;
+
+	//Free components kept per template - extras are destroyed when they finish
+	static constexpr int32 MaxFreePerTemplate{ 64 };
+
+	int32 PoolHits = 0;
+	int32 PoolMisses = 0;
+};
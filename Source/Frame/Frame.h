@@ -10,4 +10,6 @@
 #define EPS_Grass EPhysicalSurface::SurfaceType4
 #define EPS_Water EPhysicalSurface::SurfaceType5
 
+DECLARE_STATS_GROUP(TEXT("Frame"), STATGROUP_Frame, STATCAT_Advanced);
+
 
@@ -22,8 +22,14 @@
 #include "BulletHitInterface.h"
 #include "Enemy.h"
 #include "EnemyAIController.h"
-#include "BehaviorTree/BlackboardComponent.h"
 #include "FrameGameModeBase.h"
+#include "HitscanResolverSubsystem.h"
+#include "FXPoolSubsystem.h"
+#include "ProjectileSubsystem.h"
+#include "FrameDataRegistry.h"
+#include "PickupGridSubsystem.h"
+#include "PickupPoolSubsystem.h"
+#include "EnemyPerceptionSubsystem.h"
 
 // Sets default values
 AFrameCharacter::AFrameCharacter() : 
@@ -59,8 +65,20 @@ AFrameCharacter::AFrameCharacter() :
 	bFireButtonPressed(false),
 	bFiringBullet(false),
 	bShouldFire(true),
+	FireTimeRemaining(0.f),
+	LastFrameControlRotation(FRotator::ZeroRotator),
+	LastFrameMuzzleWeapon(nullptr),
+	//Crosshair query cache
+	CrosshairViewFrame(0),
+	CrosshairTraceFrame(0),
+	bCrosshairViewValid(false),
+	CrosshairWorldPosition(FVector(0.f)),
+	CrosshairWorldDirection(FVector(0.f)),
+	CrosshairHitLocation(FVector(0.f)),
+	bCrosshairHit(false),
 	//Trace variables for items
 	bShouldTraceForItems(false),
+	bAsyncItemTrace(true),
 	OverlappedItemCount(0),
 	//Camera interp locations
 	CameraInterpDistance(250.f),
@@ -68,6 +86,7 @@ AFrameCharacter::AFrameCharacter() :
 	//Start ammo amount
 	Starting9mmAmmo(85),
 	StartingARAmmo(120),
+	StartingRocketAmmo(8),
 	//Combat variables
 	CombatState(ECombatState::ECS_Unoccupied),
 	bCrouching(false),
@@ -98,6 +117,9 @@ AFrameCharacter::AFrameCharacter() :
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+	//Rocket launcher in the bag, fired through the projectile subsystem with the starting rockets
+	StartingInventoryWeapons.Add(EWeaponType::EWT_RocketLauncher);
+
 	//Create a camera boom (pulls in towards character if collision detected)
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
@@ -167,7 +189,7 @@ float AFrameCharacter::TakeDamage(float DamageAmount, struct FDamageEvent const&
 		auto EnemyController = Cast<AEnemyAIController>(EventInstigator);
 		if (EnemyController)
 		{
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(FName(TEXT("CharacterIsDead")), true);
+			EnemyController->SetCharacterIsDead(true);
 		}
 	}
 	else
@@ -181,6 +203,14 @@ float AFrameCharacter::TakeDamage(float DamageAmount, struct FDamageEvent const&
 void AFrameCharacter::Die()
 {
 	bDead = true;
+
+	//Enemies stop acquiring a dead character
+	UEnemyPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (Perception)
+	{
+		Perception->UnregisterTarget(this);
+	}
+
 	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 	if (AnimInstance && DeathMontage)
 	{
@@ -211,18 +241,55 @@ void AFrameCharacter::BeginPlay()
 
 	//Attach, equip and spawn default weapon
 	EquipWeapon(SpawnDefaultWeapon());
-	Inventory.Add(EquippedWeapon);
 	EquippedWeapon->SetSlotIndex(0);
+	InventoryRecords.Add(EquippedWeapon->MakeInventoryRecord());
 	EquippedWeapon->DisableCustomDepth();
 	EquippedWeapon->DisableGlowMaterial();
 	EquippedWeapon->SetCharacter(this);
+	AddStartingInventoryWeapons();
+	RefreshInventoryView();
 
 	InitializeAmmoMap();
 	GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;
 	
 	//Create FInterpLocation structs for each interp location and add to array
 	InitializeInterpLocations();
-	
+
+	//Enemies find the character through the perception grid rather than their own overlap spheres
+	UEnemyPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>();
+	if (Perception)
+	{
+		Perception->RegisterTarget(this);
+	}
+
+	//Prewarm pooled weapon FX so sustained fire recycles components
+	UFXPoolSubsystem* FXPool = GetWorld()->GetSubsystem<UFXPoolSubsystem>();
+	if (FXPool)
+	{
+		FXPool->PrewarmWeaponEffects(8);
+		FXPool->Prewarm(BeamParticles, 16);
+		FXPool->Prewarm(ImpactParticles, 8);
+		FXPool->Prewarm(HitParticles, 4);
+	}
+}
+
+void AFrameCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ReleaseInventoryDisplayWeapons();
+	Inventory.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AFrameCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	//Possession usually lands after BeginPlay, which is when the slot view can first be built
+	if (HasActorBegunPlay())
+	{
+		RefreshInventoryView();
+	}
 }
 
 void AFrameCharacter::MoveForward(float Value)
@@ -293,7 +360,7 @@ void AFrameCharacter::LookUp(float Value)
 }
 
 
-void AFrameCharacter::FireWeapon()
+void AFrameCharacter::FireWeapon(float ShotDelay)
 {
 	if (EquippedWeapon == nullptr) return;
 	if (CombatState != ECombatState::ECS_Unoccupied) return;
@@ -301,11 +368,12 @@ void AFrameCharacter::FireWeapon()
 	if (WeaponHasAmmo())
 	{
 		PlayFiringSound();
-		SendBullet();
+		SendBullet(ShotDelay);
 		PlayGunfireMontage();
 		EquippedWeapon->DecrementAmmo();
+		SyncEquippedRecord();
 
-		StartFireTimer();
+		StartFireTimer(ShotDelay);
 
 		if (EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol)
 		{
@@ -318,40 +386,6 @@ void AFrameCharacter::FireWeapon()
 	StartCrosshairBulletFire();
 }
 
-bool AFrameCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult)
-{
-		FVector OutBeamLocation;
-		//Check for crosshair trace hit
-		FHitResult CrosshairHitResult;
-		bool bCrosshairHit = TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation);
-
-		if (bCrosshairHit)
-		{
-			//Tentative hit location, still need to trace from gun
-			OutBeamLocation = CrosshairHitResult.Location;
-		}
-		else //No trace hit
-		{
-			//OutBeamLocation is the end location for line trace
-		}
-
-		//Perform second trace from gun barrel
-			const FVector WeaponTraceStart{ MuzzleSocketLocation };
-			const FVector StartToEnd{ OutBeamLocation - MuzzleSocketLocation };
-			const FVector WeaponTraceEnd{ MuzzleSocketLocation + StartToEnd * 1.25f };
-			GetWorld()->LineTraceSingleByChannel(
-				OutHitResult,
-				WeaponTraceStart,
-				WeaponTraceEnd,
-				ECollisionChannel::ECC_Visibility);
-			if (!OutHitResult.bBlockingHit) //Object between barrel and BeamEndPoint?
-			{
-				OutHitResult.Location = OutBeamLocation;
-				return false;
-			}
-			return true;
-}
-
 void AFrameCharacter::AimingButtonPressed()
 {
 	bAimingButtonPressed = true;
@@ -466,16 +500,17 @@ void AFrameCharacter::FireButtonReleased()
 	bFireButtonPressed = false;
 }
 
-void AFrameCharacter::StartFireTimer()
+void AFrameCharacter::StartFireTimer(float ShotDelay)
 {
 	if (EquippedWeapon == nullptr) return;
 	CombatState = ECombatState::ECS_FireTimerInProgress;
-	
-	GetWorldTimerManager().SetTimer(AutoFireTimer, 
-		this, &AFrameCharacter::AutoFireReset, EquippedWeapon->GetAutoFireRate());
+
+	//Next shot is due one fire interval after this one was due, not after this frame
+	const float FireRate{ FMath::Max(EquippedWeapon->GetAutoFireRate(), 0.001f) };
+	FireTimeRemaining = FireRate - ShotDelay;
 }
 
-void AFrameCharacter::AutoFireReset()
+void AFrameCharacter::AutoFireReset(float ShotDelay)
 {
 	if (CombatState == ECombatState::ECS_Stunned) return;
 
@@ -486,7 +521,7 @@ void AFrameCharacter::AutoFireReset()
 	{
 		if (bFireButtonPressed && EquippedWeapon->GetAutomatic())
 		{
-			FireWeapon();
+			FireWeapon(ShotDelay);
 		}
 	}
 	else
@@ -497,8 +532,37 @@ void AFrameCharacter::AutoFireReset()
 		
 }
 
-bool AFrameCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
+void AFrameCharacter::UpdateFireScheduler(float DeltaTime)
 {
+	if (CombatState == ECombatState::ECS_FireTimerInProgress)
+	{
+		FireTimeRemaining -= DeltaTime;
+
+		//Fire every shot owed this frame - a long frame can owe several at high fire rates
+		while (CombatState == ECombatState::ECS_FireTimerInProgress && FireTimeRemaining <= 0.f)
+		{
+			AutoFireReset(-FireTimeRemaining);
+		}
+	}
+
+	LastFrameControlRotation = GetControlRotation();
+
+	//Muzzle at the end of this frame, the start point for shots the fire timer owes part way through the next one
+	const bool bShotsOwedNextFrame{ CombatState == ECombatState::ECS_FireTimerInProgress && EquippedWeapon };
+	const USkeletalMeshSocket* BarrelSocket = bShotsOwedNextFrame ? EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket") : nullptr;
+	LastFrameMuzzleWeapon = BarrelSocket ? EquippedWeapon : nullptr;
+	if (BarrelSocket)
+	{
+		LastFrameMuzzleTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+	}
+}
+
+bool AFrameCharacter::UpdateCrosshairView()
+{
+	//Already deprojected this frame
+	if (CrosshairViewFrame == GFrameCounter) return bCrosshairViewValid;
+	CrosshairViewFrame = GFrameCounter;
+
 	//Get viewport size
 	FVector2D ViewportSize;
 		if (GEngine && GEngine->GameViewport)
@@ -507,105 +571,182 @@ bool AFrameCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& Ou
 		}
 	//Get screen space location of crosshairs
 	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
 
 	//Get world position and direction of crosshairs
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(
+	bCrosshairViewValid = UGameplayStatics::DeprojectScreenToWorld(
 		UGameplayStatics::GetPlayerController(this, 0),
 		CrosshairLocation,
-		CrosshairWorldPosition, 
+		CrosshairWorldPosition,
 		CrosshairWorldDirection);
 
-		if (bScreenToWorld)
+	return bCrosshairViewValid;
+}
+
+bool AFrameCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
+{
+	//Trace once per frame, every later caller gets the cached hit
+	if (CrosshairTraceFrame != GFrameCounter)
+	{
+		CrosshairTraceFrame = GFrameCounter;
+		CrosshairHitResult = FHitResult();
+		bCrosshairHit = false;
+
+		if (UpdateCrosshairView())
 		{
 			//Trace from crosshair world location outward
 			const FVector Start{ CrosshairWorldPosition };
 			const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
-			OutHitLocation = End;
-			GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
-		
-			if (OutHitResult.bBlockingHit)
+			CrosshairHitLocation = End;
+			GetWorld()->LineTraceSingleByChannel(CrosshairHitResult, Start, End, ECollisionChannel::ECC_Visibility);
+
+			if (CrosshairHitResult.bBlockingHit)
 			{
-				OutHitLocation = OutHitResult.Location;
-				return true;
+				CrosshairHitLocation = CrosshairHitResult.Location;
+				bCrosshairHit = true;
 			}
 		}
-		return false;
+	}
+
+	OutHitResult = CrosshairHitResult;
+	OutHitLocation = CrosshairHitLocation;
+	return bCrosshairHit;
 }
 
 void AFrameCharacter::TraceForItems()
 {
 	if (bShouldTraceForItems)
 	{
-
-		FHitResult ItemTraceResult;
-		FVector HitLocation;
-		TraceUnderCrosshairs(ItemTraceResult, HitLocation);
-		if (ItemTraceResult.bBlockingHit)
+		if (bAsyncItemTrace)
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
-			const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem); //So animation on inventory only plays when tracing over weapons
-			if (TraceHitWeapon)
+			//Consume the trace queued last frame every frame, then queue one for next frame
+			FTraceDatum ItemTraceDatum;
+			const bool bItemTraceDone{ GetWorld()->QueryTraceData(ItemTraceHandle, ItemTraceDatum) };
+			if (CrosshairTraceFrame == GFrameCounter)
 			{
-				if (HighlightedSlot == -1)
-				{
-					HighlightInventorySlot(); //Not highlighting slot, highlight one now
-				}
+				//A shot already traced the crosshair this frame, its hit is newer than last frame's trace
+				FHitResult ItemTraceResult;
+				FVector HitLocation;
+				TraceUnderCrosshairs(ItemTraceResult, HitLocation);
+				UpdateTraceHitItem(ItemTraceResult);
 			}
-			else
+			else if (bItemTraceDone)
 			{
-				//Is slot highlighted?
-				if (HighlightedSlot != -1)
-				{
-					//Unhighlight slot
-					UnhighlightInventorySlot();
-				}
+				UpdateTraceHitItem(ItemTraceDatum.OutHits.Num() > 0 ? ItemTraceDatum.OutHits[0] : FHitResult());
 			}
-			if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterping)
+			QueueAsyncItemTrace();
+		}
+		else
+		{
+			//Blocking trace, or reuse the crosshair hit a shot already traced this frame
+			FHitResult ItemTraceResult;
+			FVector HitLocation;
+			TraceUnderCrosshairs(ItemTraceResult, HitLocation);
+			UpdateTraceHitItem(ItemTraceResult);
+		}
+	}
+	else if (TraceHitItemLastFrame)
+	{
+		//No longer overlapping any items, item from last frame should not show widget
+		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
+		TraceHitItemLastFrame->DisableCustomDepth();
+	}
+}
+
+void AFrameCharacter::QueueAsyncItemTrace()
+{
+	if (!UpdateCrosshairView())
+	{
+		ItemTraceHandle = FTraceHandle();
+		return;
+	}
+
+	//Trace from crosshair world location outward, result is ready next frame
+	const FVector Start{ CrosshairWorldPosition };
+	const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
+	ItemTraceHandle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECollisionChannel::ECC_Visibility);
+}
+
+void AFrameCharacter::UpdateTraceHitItem(const FHitResult& ItemTraceResult)
+{
+	if (ItemTraceResult.bBlockingHit)
+	{
+		TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
+		const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem); //So animation on inventory only plays when tracing over weapons
+		if (TraceHitWeapon)
+		{
+			if (HighlightedSlot == -1)
 			{
-				TraceHitItem = nullptr; //So we can't spam the select button
+				HighlightInventorySlot(); //Not highlighting slot, highlight one now
 			}
-
-			if (TraceHitItem && TraceHitItem->GetPickupWidget())
+		}
+		else
+		{
+			//Is slot highlighted?
+			if (HighlightedSlot != -1)
 			{
-				//Show item's pickup widget
-				TraceHitItem->GetPickupWidget()->SetVisibility(true);
-				TraceHitItem->EnableCustomDepth();
-
-				if (Inventory.Num() >= INVENTORY_CAPACITY)
-				{
-					//Inventory full
-					TraceHitItem->SetCharacterInventoryFull(true);
-				}
-				else
-				{
-					//Inventory not full
-					TraceHitItem->SetCharacterInventoryFull(false);
-				}
+				//Unhighlight slot
+				UnhighlightInventorySlot();
 			}
+		}
+		if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterping)
+		{
+			TraceHitItem = nullptr; //So we can't spam the select button
+		}
 
+		if (TraceHitItem && TraceHitItem->GetPickupWidget())
+		{
+			//Show item's pickup widget
+			TraceHitItem->GetPickupWidget()->SetVisibility(true);
+			TraceHitItem->EnableCustomDepth();
 
-			//Hit AItem at last frame
-			if (TraceHitItemLastFrame)
+			if (InventoryRecords.Num() >= INVENTORY_CAPACITY)
 			{
-				if (TraceHitItem != TraceHitItemLastFrame)
-				{
-					//We are hitting a different AItem this frame from last frame
-					//Or AItem is null
-					TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
-					TraceHitItemLastFrame->DisableCustomDepth();
-				}
-			}				
-			//Store reference to HitItem for next frame
-			TraceHitItemLastFrame = TraceHitItem;
+				//Inventory full
+				TraceHitItem->SetCharacterInventoryFull(true);
+			}
+			else
+			{
+				//Inventory not full
+				TraceHitItem->SetCharacterInventoryFull(false);
+			}
 		}
+
+
+		//Hit AItem at last frame
+		if (TraceHitItemLastFrame)
+		{
+			if (TraceHitItem != TraceHitItemLastFrame)
+			{
+				//We are hitting a different AItem this frame from last frame
+				//Or AItem is null
+				TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
+				TraceHitItemLastFrame->DisableCustomDepth();
+			}
+		}				
+		//Store reference to HitItem for next frame
+		TraceHitItemLastFrame = TraceHitItem;
 	}
-	else if (TraceHitItemLastFrame)
+}
+
+void AFrameCharacter::AddStartingInventoryWeapons()
+{
+	if (InventoryRecords.Num() == 0) return;
+
+	for (const EWeaponType WeaponType : StartingInventoryWeapons)
 	{
-		//No longer overlapping any items, item from last frame should not show widget
-		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
-		TraceHitItemLastFrame->DisableCustomDepth();
+		if (InventoryRecords.Num() >= INVENTORY_CAPACITY) break;
+
+		const FWeaponDataTable* WeaponDataRow = UFrameDataRegistry::GetDataTables(this).GetWeaponData(WeaponType);
+		if (WeaponDataRow == nullptr) continue;
+
+		//Same class and rarity as the default weapon, rehydrated as this type when equipped
+		FInventoryRecord Record{ InventoryRecords[0] };
+		Record.WeaponType = WeaponType;
+		Record.Ammo = WeaponDataRow->WeaponAmmo;
+		Record.SlotIndex = InventoryRecords.Num();
+		Record.IconItem = WeaponDataRow->InventoryIcon;
+		Record.AmmoItem = WeaponDataRow->AmmoIcon;
+		InventoryRecords.Add(Record);
 	}
 }
 
@@ -614,8 +755,8 @@ AWeapon* AFrameCharacter::SpawnDefaultWeapon()
 	//Check the TSubclassOf variable on editor
 	if (DefaultWeaponClass)
 	{
-		//Spawn weapon
-		return GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass);
+		//Spawn weapon, reusing a pooled one when available
+		return UPickupPoolSubsystem::SpawnItem<AWeapon>(this, DefaultWeaponClass, GetActorTransform(), EItemState::EIS_Equipped);
 	}
 
 	return nullptr;
@@ -678,14 +819,15 @@ void AFrameCharacter::SelectButtonReleased()
 
 void AFrameCharacter::SwapWeapon(AWeapon* WeaponToSwap)
 {
-	if (Inventory.Num() -1 >= EquippedWeapon->GetSlotIndex())
+	if (InventoryRecords.Num() -1 >= EquippedWeapon->GetSlotIndex())
 	{
-		Inventory[EquippedWeapon->GetSlotIndex()] = WeaponToSwap;
-		WeaponToSwap->SetSlotIndex(EquippedWeapon->GetSlotIndex());		
+		WeaponToSwap->SetSlotIndex(EquippedWeapon->GetSlotIndex());
+		InventoryRecords[EquippedWeapon->GetSlotIndex()] = WeaponToSwap->MakeInventoryRecord();
 	}
 	
 	DropWeapon();
 	EquipWeapon(WeaponToSwap, true);
+	RefreshInventoryView();
 	TraceHitItem = nullptr;
 	TraceHitItemLastFrame = nullptr;
 }
@@ -695,6 +837,7 @@ void AFrameCharacter::InitializeAmmoMap()
 {
 	AmmoMap.Add(EAmmoType::EAT_9mm, Starting9mmAmmo);
 	AmmoMap.Add(EAmmoType::EAT_AR, StartingARAmmo);
+	AmmoMap.Add(EAmmoType::EAT_Rocket, StartingRocketAmmo);
 }
 
 bool AFrameCharacter::WeaponHasAmmo()
@@ -713,65 +856,62 @@ void AFrameCharacter::PlayFiringSound()
 	}
 }
 
-void AFrameCharacter::SendBullet()
+void AFrameCharacter::SendBullet(float ShotDelay)
 {
 	//Send bullet
 	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
 	if (BarrelSocket)
 	{
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+		FTransform SocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+
+		//Aim at whatever is under the crosshairs, or the end of the crosshair trace
+		FHitResult CrosshairHit;
+		FVector AimLocation;
+		TraceUnderCrosshairs(CrosshairHit, AimLocation);
 
-		if (EquippedWeapon->GetMuzzleFlash())
+		//Shot was due part way through the frame - fire from where the muzzle was and aim where the view was pointing at that time
+		const float DeltaSeconds{ GetWorld()->GetDeltaSeconds() };
+		const float ShotAlpha{ DeltaSeconds > 0.f ? 1.f - FMath::Clamp(ShotDelay / DeltaSeconds, 0.f, 1.f) : 1.f };
+		if (ShotAlpha < 1.f && LastFrameMuzzleWeapon == EquippedWeapon)
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+			SocketTransform.BlendWith(LastFrameMuzzleTransform, 1.f - ShotAlpha);
 		}
-	
-		FHitResult BeamHitResult;
-		bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamHitResult);
-		if (bBeamEnd)
+		if (ShotAlpha < 1.f && bCrosshairViewValid)
 		{
-			//Check if hit actor implement BulletHitInterface
-			if (BeamHitResult.GetActor())
-			{
-				IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(BeamHitResult.GetActor());
-				if (BulletHitInterface)
-				{
-					BulletHitInterface->BulletHit_Implementation(BeamHitResult, this, GetController());
-				}
-
-				AEnemy* HitEnemy = Cast<AEnemy>(BeamHitResult.GetActor());
-				if (HitEnemy)
-				{
-					int32 Damage{};
-					if (BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone())
-					{
-						//Headshot
-						Damage = EquippedWeapon->GetHeadshotDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(), Damage, GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitPoint(Damage, BeamHitResult.Location, true);
-					}
-					else
-					{
-						//Body shot
-						Damage = EquippedWeapon->GetDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(), Damage, GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitPoint(Damage, BeamHitResult.Location, false);
-					}
-				}
-			}
-			else
-			{
-				if (ImpactParticles) //Spawn default particles
-				{
-					UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, BeamHitResult.Location);
-				}
-			}
+			const FQuat CurrentRotation{ GetControlRotation().Quaternion() };
+			const FQuat ShotRotation{ FQuat::Slerp(LastFrameControlRotation.Quaternion(), CurrentRotation, ShotAlpha) };
+			const FVector ShotDirection{ (ShotRotation * CurrentRotation.Inverse()).RotateVector(CrosshairWorldDirection) };
+			AimLocation = CrosshairWorldPosition + ShotDirection * FVector::Dist(CrosshairWorldPosition, AimLocation);
+		}
 
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
-			if (Beam)
+		if (EquippedWeapon->FiresProjectiles())
+		{
+			//Rockets fly from the barrel and are simulated with every other projectile
+			UProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+			if (Projectiles)
 			{
-				Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
+				UFXPoolSubsystem::SpawnEmitter(this, EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+				Projectiles->LaunchProjectile(this, GetController(), SocketTransform.GetLocation(),
+					AimLocation - SocketTransform.GetLocation(), EquippedWeapon->GetDamage(), EquippedWeapon->GetProjectileSettings());
 			}
+			return;
+		}
+
+		//Barrel trace, damage and FX are resolved with every other shot this frame
+		UHitscanResolverSubsystem* HitscanResolver = GetWorld()->GetSubsystem<UHitscanResolverSubsystem>();
+		if (HitscanResolver)
+		{
+			FHitscanRequest Shot;
+			Shot.Shooter = this;
+			Shot.InstigatorController = GetController();
+			Shot.MuzzleTransform = SocketTransform;
+			Shot.AimLocation = AimLocation;
+			Shot.Damage = EquippedWeapon->GetDamage();
+			Shot.HeadshotDamage = EquippedWeapon->GetHeadshotDamage();
+			Shot.MuzzleFlash = EquippedWeapon->GetMuzzleFlash();
+			Shot.BeamParticles = BeamParticles;
+			Shot.ImpactParticles = ImpactParticles;
+			HitscanResolver->QueueShot(Shot);
 		}
 	}
 }
@@ -891,7 +1031,7 @@ void AFrameCharacter::FinishReloading()
 			CarriedAmmo -= MagEmptySpace;
 			AmmoMap.Add(AmmoType, CarriedAmmo);
 		}
-
+		SyncEquippedRecord();
 	}
 }
 
@@ -984,7 +1124,8 @@ void AFrameCharacter::PickUpAmmo(AAmmo* Ammo)
 		}
 	}
 
-	Ammo->Destroy();
+	//Back to the pool for the next drop
+	UPickupPoolSubsystem::ReleaseItem(this, Ammo);
 }
 
 void AFrameCharacter::Stun()
@@ -1092,22 +1233,28 @@ void AFrameCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewIt
 {
 	const bool bCanExchangeItems = 
 				(CurrentItemIndex != NewItemIndex) &&
-				(NewItemIndex < Inventory.Num()) && 
+				(NewItemIndex < InventoryRecords.Num()) && 
+				InventoryRecords[NewItemIndex].IsValid() &&
 				(CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping);
 	
 	if (bCanExchangeItems)
 	{
+		auto NewWeapon = RehydrateInventoryItem(NewItemIndex);
+		if (NewWeapon == nullptr) return;
+
 		if (bAiming)
 		{
 			StopAiming();
 		}
 		
 		auto OldEquippedWeapon = EquippedWeapon;
-		auto NewWeapon = Cast<AWeapon>(Inventory[NewItemIndex]);
 		EquipWeapon(NewWeapon);
 
-		OldEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
+		//Old weapon goes back to being a record
+		InventoryRecords[CurrentItemIndex] = OldEquippedWeapon->MakeInventoryRecord();
+		UPickupPoolSubsystem::ReleaseItem(this, OldEquippedWeapon);
 		NewWeapon->SetItemState(EItemState::EIS_Equipped);
+		RefreshInventoryView();
 
 		CombatState = ECombatState::ECS_Equipping;
 		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
@@ -1136,12 +1283,16 @@ void AFrameCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	//Fire automatic shots owed since last frame
+	UpdateFireScheduler(DeltaTime);
 	//Handles interp for zoom when aiming
 	CameraInterpZoom(DeltaTime);
 	//Change look sensitivity based on aiming
 	SetLookRates();
 	//Calculate crosshair spread
 	CalculateCrosshairSpread(DeltaTime);
+	//Count items around us from the pickup grid
+	UpdateNearbyItems();
 	//Check for OverlappedItemCount then trace for items
 	TraceForItems();
 	//Interpolate capsule half height based on standing/crouching
@@ -1190,18 +1341,47 @@ float AFrameCharacter::GetCrosshairSpreadMultiplier() const
 	return CrosshairSpreadMultiplier;
 }
 
-void AFrameCharacter::IncrementOverlappedItemCount(int8 Amount)
+void AFrameCharacter::UpdateNearbyItems()
 {
-	if (OverlappedItemCount + Amount <= 0)
+	UPickupGridSubsystem* PickupGrid = GetWorld()->GetSubsystem<UPickupGridSubsystem>();
+	if (PickupGrid == nullptr) return;
+
+	//Same shape the sphere overlaps used to test against - a segment swept by the capsule radius
+	const UCapsuleComponent* Capsule = GetCapsuleComponent();
+	const float CapsuleRadius{ Capsule->GetScaledCapsuleRadius() };
+	const float CapsuleHalfHeight{ Capsule->GetScaledCapsuleHalfHeight() };
+	const FVector Location{ Capsule->GetComponentLocation() };
+	const FVector SegmentOffset{ Capsule->GetUpVector() * (CapsuleHalfHeight - CapsuleRadius) };
+	const FVector SegmentStart{ Location - SegmentOffset };
+	const FVector SegmentEnd{ Location + SegmentOffset };
+
+	NearbyItems.Reset();
+	PickupGrid->QueryPickups(Location, CapsuleHalfHeight, NearbyItems);
+
+	int32 ItemCount{ 0 };
+	for (AItem* Item : NearbyItems)
 	{
-		OverlappedItemCount = 0;
-		bShouldTraceForItems = false;
+		//Capsule surface to item centre, negative when the item is inside the capsule
+		const float Distance{ FMath::PointDistToSegment(Item->GetActorLocation(), SegmentStart, SegmentEnd) - CapsuleRadius };
+		const float AutoPickupRadius{ Item->GetAutoPickupRadius() };
+		if (AutoPickupRadius > 0.f && Distance <= AutoPickupRadius)
+		{
+			//Leaves the pickup state and the grid
+			Item->StartItemCurve(this);
+			continue;
+		}
+		if (Distance <= Item->GetOverlapRadius())
+		{
+			ItemCount++;
+		}
 	}
-	else
+
+	if (ItemCount == 0 && OverlappedItemCount > 0)
 	{
-		OverlappedItemCount += Amount;
-		bShouldTraceForItems = true;
+		UnhighlightInventorySlot();
 	}
+	OverlappedItemCount = ItemCount;
+	bShouldTraceForItems = OverlappedItemCount > 0;
 }
 
 /* No longer needed; AItem has InterpLocation
@@ -1220,11 +1400,13 @@ void AFrameCharacter::GetPickupItem(AItem* Item)
 	auto Weapon = Cast<AWeapon>(Item);
 	if (Weapon)
 	{
-		if (Inventory.Num() < INVENTORY_CAPACITY)
+		if (InventoryRecords.Num() < INVENTORY_CAPACITY)
 		{
-			Weapon->SetSlotIndex(Inventory.Num());
-			Inventory.Add(Weapon);
-			Weapon->SetItemState(EItemState::EIS_PickedUp);
+			//Stored as a record, the actor goes back to the pickup pool
+			Weapon->SetSlotIndex(InventoryRecords.Num());
+			InventoryRecords.Add(Weapon->MakeInventoryRecord());
+			UPickupPoolSubsystem::ReleaseItem(this, Weapon);
+			RefreshInventoryView();
 		}
 		else // Inventory is full. Swap with equipped weapon
 		{
@@ -1254,21 +1436,121 @@ void AFrameCharacter::FinishEquipping()
 
 int32 AFrameCharacter::GetEmptyInventorySlot()
 {
-	for (int32 i = 0; i < Inventory.Num(); i++)
+	for (int32 i = 0; i < InventoryRecords.Num(); i++)
 	{
-		if (Inventory[i] == nullptr)
+		if (!InventoryRecords[i].IsValid())
 		{
 			return i;
 		}
 	}
-	if (Inventory.Num() < INVENTORY_CAPACITY)
+	if (InventoryRecords.Num() < INVENTORY_CAPACITY)
 	{
-		return Inventory.Num();
+		return InventoryRecords.Num();
 	}
 
 	return -1; //Inventory full
 }
 
+AWeapon* AFrameCharacter::RehydrateInventoryItem(int32 SlotIndex)
+{
+	if (!InventoryRecords.IsValidIndex(SlotIndex) || !InventoryRecords[SlotIndex].IsValid()) return nullptr;
+
+	const FInventoryRecord& Record = InventoryRecords[SlotIndex];
+	AWeapon* Weapon = Cast<AWeapon>(UPickupPoolSubsystem::SpawnItem(this, Record.ItemClass, GetActorTransform(), Record.Rarity, Record.ItemCount, EItemState::EIS_PickedUp));
+	if (Weapon)
+	{
+		Weapon->ApplyInventoryRecord(Record);
+		Weapon->SetCharacter(this);
+		Weapon->DisableCustomDepth();
+		Weapon->DisableGlowMaterial();
+	}
+	return Weapon;
+}
+
+void AFrameCharacter::SyncEquippedRecord()
+{
+	if (EquippedWeapon && InventoryRecords.IsValidIndex(EquippedWeapon->GetSlotIndex()))
+	{
+		InventoryRecords[EquippedWeapon->GetSlotIndex()] = EquippedWeapon->MakeInventoryRecord();
+	}
+}
+
+void AFrameCharacter::RefreshInventoryView()
+{
+	Inventory.Reset();
+
+	//Only the local player's HUD reads the slot actors
+	if (!IsPlayerControlled() || !IsLocallyControlled())
+	{
+		ReleaseInventoryDisplayWeapons();
+		return;
+	}
+
+	for (int32 i = InventoryRecords.Num(); i < InventoryDisplayWeapons.Num(); i++)
+	{
+		if (InventoryDisplayWeapons[i])
+		{
+			UPickupPoolSubsystem::ReleaseItem(this, InventoryDisplayWeapons[i]);
+		}
+	}
+	InventoryDisplayWeapons.SetNum(InventoryRecords.Num());
+
+	for (int32 i = 0; i < InventoryRecords.Num(); i++)
+	{
+		AWeapon*& DisplayWeapon = InventoryDisplayWeapons[i];
+		const FInventoryRecord& Record = InventoryRecords[i];
+		const bool bEquippedSlot{ EquippedWeapon && EquippedWeapon->GetSlotIndex() == i };
+
+		//Drop the stand-in when the slot is equipped, emptied or now holds another class
+		if (DisplayWeapon && (bEquippedSlot || !Record.IsValid() || DisplayWeapon->GetClass() != Record.ItemClass))
+		{
+			UPickupPoolSubsystem::ReleaseItem(this, DisplayWeapon);
+			DisplayWeapon = nullptr;
+		}
+
+		if (bEquippedSlot)
+		{
+			Inventory.Add(EquippedWeapon);
+			continue;
+		}
+
+		if (Record.IsValid())
+		{
+			if (DisplayWeapon)
+			{
+				DisplayWeapon->ApplyInventoryRecord(Record);
+			}
+			else
+			{
+				DisplayWeapon = RehydrateInventoryItem(i);
+			}
+		}
+		Inventory.Add(DisplayWeapon);
+	}
+}
+
+void AFrameCharacter::ReleaseInventoryDisplayWeapons()
+{
+	for (AWeapon* DisplayWeapon : InventoryDisplayWeapons)
+	{
+		if (DisplayWeapon)
+		{
+			UPickupPoolSubsystem::ReleaseItem(this, DisplayWeapon);
+		}
+	}
+	InventoryDisplayWeapons.Reset();
+}
+
+bool AFrameCharacter::GetInventoryRecord(int32 SlotIndex, FInventoryRecord& OutRecord) const
+{
+	if (InventoryRecords.IsValidIndex(SlotIndex) && InventoryRecords[SlotIndex].IsValid())
+	{
+		OutRecord = InventoryRecords[SlotIndex];
+		return true;
+	}
+	return false;
+}
+
 void AFrameCharacter::HighlightInventorySlot()
 {
 	const int32 EmptySlot{ GetEmptyInventorySlot() };
@@ -4,7 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "WorldCollision.h"
 #include "AmmoType.h"
+#include "Weapon.h"
 #include "FrameCharacter.generated.h"
 
 UENUM(BlueprintType)
@@ -54,6 +56,10 @@ protected:
 	//Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void NotifyControllerChanged() override;
+
 	//Called for forwards/backwards input
 	void MoveForward(float Value);
 
@@ -75,10 +81,9 @@ protected:
 	//Param Rate - input value from mouse movement
 	void LookUp(float Value);
 
-	//Called when fire button is pressed
-	void FireWeapon();
-
-	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult);
+	//Called when fire button is pressed or a scheduled automatic shot comes due
+	//Param ShotDelay - seconds between when the shot was due and the end of this frame
+	void FireWeapon(float ShotDelay = 0.f);
 
 	//Set bAiming to true or false with button/trigger press
 	void AimingButtonPressed();
@@ -98,17 +103,32 @@ protected:
 	void FireButtonPressed();
 	void FireButtonReleased();
 
-	void StartFireTimer();
+	//Schedules the next automatic shot, keeping time already owed from this frame
+	void StartFireTimer(float ShotDelay = 0.f);
 
-	UFUNCTION()
-	void AutoFireReset();
+	void AutoFireReset(float ShotDelay);
+
+	//Fires every shot that came due this frame - called from Tick
+	void UpdateFireScheduler(float DeltaTime);
 
-	//Line trace for items under crosshairs
+	//Deprojects screen centre into a world ray - computed once per frame and shared by all crosshair queries
+	bool UpdateCrosshairView();
+
+	//Line trace for items under crosshairs - hit is cached for the rest of the frame
 	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
 
 	//Trace for items if overlapped item count > 0
 	void TraceForItems();
 
+	//Queries the pickup grid for items around us, updates OverlappedItemCount and collects walked-over ammo
+	void UpdateNearbyItems();
+
+	//Queues a non-blocking crosshair trace whose result is read next frame
+	void QueueAsyncItemTrace();
+
+	//Updates pickup widget, custom depth and inventory highlight from an item trace
+	void UpdateTraceHitItem(const FHitResult& ItemTraceResult);
+
 	//Spawns and equips default weapon to character
 	class AWeapon* SpawnDefaultWeapon();
 
@@ -127,12 +147,15 @@ protected:
 	//Initialize ammo map with values
 	void InitializeAmmoMap();
 
+	//Inventory records for StartingInventoryWeapons, after the default weapon's
+	void AddStartingInventoryWeapons();
+
 	//Check weapon has ammo
 	bool WeaponHasAmmo();
 	
 	//Fire weapon functions
 	void PlayFiringSound();
-	void SendBullet();
+	void SendBullet(float ShotDelay);
 	void PlayGunfireMontage();
 
 	//Bound to R/X/Square
@@ -183,6 +206,17 @@ protected:
 
 	int32 GetEmptyInventorySlot();
 
+	//Spawns the weapon stored in the inventory slot through the pickup pool
+	AWeapon* RehydrateInventoryItem(int32 SlotIndex);
+
+	//Copies the equipped weapon's live state into its slot, called whenever its ammo changes
+	void SyncEquippedRecord();
+
+	//Rebuilds Inventory from the records and the equipped weapon, called whenever a slot changes
+	void RefreshInventoryView();
+
+	void ReleaseInventoryDisplayWeapons();
+
 	void HighlightInventorySlot();
 
 	UFUNCTION(BlueprintCallable)
@@ -313,18 +347,53 @@ private:
 	//True when we can fire, false when waiting for timer
 	bool bShouldFire;
 
-	//Sets timer between gunshots
-	FTimerHandle AutoFireTimer;
+	//Time left before the next automatic shot, negative once it is overdue
+	float FireTimeRemaining;
+
+	//Control rotation at the end of last frame, used to aim shots fired between frames
+	FRotator LastFrameControlRotation;
+
+	//Barrel socket at the end of last frame and the weapon it was read from, used to place shots fired between frames
+	FTransform LastFrameMuzzleTransform;
+	AWeapon* LastFrameMuzzleWeapon;
 
 	float ShootTimeDuration;
 	bool bFiringBullet;
 	FTimerHandle CrosshairShootTimer;
 
+	//Frame number the crosshair view ray was last deprojected on
+	uint64 CrosshairViewFrame;
+
+	//Frame number the crosshair hit was last traced on
+	uint64 CrosshairTraceFrame;
+
+	//True if the deprojection succeeded this frame
+	bool bCrosshairViewValid;
+
+	//World ray through the centre of the screen this frame
+	FVector CrosshairWorldPosition;
+	FVector CrosshairWorldDirection;
+
+	//Crosshair trace result this frame
+	FHitResult CrosshairHitResult;
+	FVector CrosshairHitLocation;
+	bool bCrosshairHit;
+
 	//True if we trace every frame for items
 	bool bShouldTraceForItems;
 
-	//Number of overlapped AItems
-	int8 OverlappedItemCount;
+	//When true item traces run asynchronously and drive highlighting one frame late
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
+	bool bAsyncItemTrace;
+
+	//Handle for the async item trace queued last frame
+	FTraceHandle ItemTraceHandle;
+
+	//Number of AItems whose area sphere we are inside, counted from the pickup grid
+	int32 OverlappedItemCount;
+
+	//Pickup grid results, kept to avoid reallocating every frame
+	TArray<class AItem*> NearbyItems;
 
 	//The AItem we hit last frame
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
@@ -338,6 +407,10 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<AWeapon> DefaultWeaponClass;
 
+	//Further weapons of the default weapon class carried in the inventory from the start
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	TArray<EWeaponType> StartingInventoryWeapons;
+
 	//Item currently hit by trace when tracing for items - can/could be null
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	AItem* TraceHitItem;
@@ -362,6 +435,10 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
 	int32 StartingARAmmo;
 
+	//Starting amount of rockets
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
+	int32 StartingRocketAmmo;
+
 	//Combat state - can only fire/reload when unoccupied
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	ECombatState CombatState;
@@ -457,10 +534,19 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	float EquipSoundResetTime;
 
-	//Weapon inventory system of AItems
+	//Weapon inventory, only the equipped weapon exists as an actor
+	UPROPERTY(VisibleAnywhere, Category = Inventory)
+	TArray<FInventoryRecord> InventoryRecords;
+
+	//Slot actors for WBP_InventoryBar and WBP_WeaponSlot until they read GetInventoryRecord.
+	//Built only for the locally controlled player, bots keep records alone
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	TArray<AItem*> Inventory;
 
+	//Hidden stand-ins shown in Inventory for the slots that are not equipped
+	UPROPERTY()
+	TArray<AWeapon*> InventoryDisplayWeapons;
+
 	const int32 INVENTORY_CAPACITY{ 6 };
 
 	//Delegate for sending inventory slot information to inventory bar when equipping items
@@ -521,16 +607,21 @@ public:
 	UFUNCTION(BlueprintCallable)
 	float GetCrosshairSpreadMultiplier() const;
 
-	FORCEINLINE int8 GetOverlappedItemCount() const { return OverlappedItemCount; }
-
-	//Adds/subtracts to/from OverlappedItemCount and updates bShouldTraceForItems
-	void IncrementOverlappedItemCount(int8 Amount);
+	FORCEINLINE int32 GetOverlappedItemCount() const { return OverlappedItemCount; }
 
 	//No longet needed; AItem has GetInterpLocation function
 	//FVector GetCameraInterpLocation();
 
 	void GetPickupItem(AItem* Item);
 
+	//Record for the slot, false for an empty slot
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool GetInventoryRecord(int32 SlotIndex, FInventoryRecord& OutRecord) const;
+
+	//Number of slots in use, including emptied ones below the last weapon
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	int32 GetInventorySize() const { return InventoryRecords.Num(); }
+
 	FORCEINLINE ECombatState GetCombatState() const { return CombatState; }
 
 	FORCEINLINE bool GetCrouching() const { return bCrouching; }
@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FrameDataRegistry.h"
+#include "Engine/Engine.h"
+
+namespace
+{
+	const TCHAR* ItemStatTablePath{ TEXT("DataTable'/Game/_Game/Data_Tables/ItemStatDataTable.ItemStatDataTable'") };
+	const TCHAR* WeaponTablePath{ TEXT("DataTable'/Game/_Game/Data_Tables/WeaponDataTable.WeaponDataTable'") };
+
+	//Row name for each EItemRarity
+	const FName ItemStatRowNames[] =
+	{
+		FName("Damaged"),
+		FName("Working"),
+		FName("Standard"),
+		FName("Super"),
+		FName("Hyper")
+	};
+	static_assert(UE_ARRAY_COUNT(ItemStatRowNames) == static_cast<int32>(EItemRarity::EIR_MAX), "Row name needed for every item rarity");
+
+	//Row name for each EWeaponType
+	const FName WeaponRowNames[] =
+	{
+		FName("SubmachineGun"),
+		FName("AssaultRifle"),
+		FName("Pistol"),
+		FName("RocketLauncher")
+	};
+	static_assert(UE_ARRAY_COUNT(WeaponRowNames) == static_cast<int32>(EWeaponType::EWT_MAX), "Row name needed for every weapon type");
+}
+
+void FFrameDataTables::Load()
+{
+	bLoaded = true;
+
+	ItemStatTable = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, ItemStatTablePath));
+	if (ItemStatTable == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Item stat data table failed to load: %s"), ItemStatTablePath);
+	}
+
+	WeaponTable = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, WeaponTablePath));
+	if (WeaponTable == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Weapon data table failed to load: %s"), WeaponTablePath);
+	}
+
+	ResolveRows();
+}
+
+void FFrameDataTables::ResolveRows()
+{
+	ItemStatRows.Init(nullptr, UE_ARRAY_COUNT(ItemStatRowNames));
+	if (ItemStatTable)
+	{
+		for (int32 Rarity = 0; Rarity < ItemStatRows.Num(); Rarity++)
+		{
+			ItemStatRows[Rarity] = ItemStatTable->FindRow<FItemStatTable>(ItemStatRowNames[Rarity], TEXT("FFrameDataTables::ResolveRows"));
+		}
+	}
+
+	WeaponRows.Init(nullptr, UE_ARRAY_COUNT(WeaponRowNames));
+	if (WeaponTable)
+	{
+		for (int32 Type = 0; Type < WeaponRows.Num(); Type++)
+		{
+			//The rocket launcher has a stand in, so its missing row only warns once below
+			const bool bWarnIfMissing{ Type != static_cast<int32>(EWeaponType::EWT_RocketLauncher) };
+			WeaponRows[Type] = WeaponTable->FindRow<FWeaponDataTable>(WeaponRowNames[Type], TEXT("FFrameDataTables::ResolveRows"), bWarnIfMissing);
+		}
+	}
+
+	//Until the table has a rocket launcher row, stand one in on the assault rifle's assets
+	bRocketLauncherStandIn = WeaponRows[static_cast<int32>(EWeaponType::EWT_RocketLauncher)] == nullptr;
+	if (bRocketLauncherStandIn)
+	{
+		const FWeaponDataTable* AssaultRifleRow = GetWeaponData(EWeaponType::EWT_AssaultRifle);
+		RocketLauncherStandIn = AssaultRifleRow ? *AssaultRifleRow : FWeaponDataTable();
+		RocketLauncherStandIn.AmmoType = EAmmoType::EAT_Rocket;
+		RocketLauncherStandIn.WeaponAmmo = 1;
+		RocketLauncherStandIn.MagazineCapacity = 1;
+		RocketLauncherStandIn.ItemName = TEXT("Rocket Launcher");
+		RocketLauncherStandIn.AutoFireRate = 1.f;
+		RocketLauncherStandIn.bAutomatic = false;
+		RocketLauncherStandIn.Damage = 100.f;
+		RocketLauncherStandIn.HeadshotDamage = 100.f;
+		RocketLauncherStandIn.Projectile = FProjectileSettings();
+
+		UE_LOG(LogTemp, Warning, TEXT("Weapon data table has no RocketLauncher row, using the built in stand in"));
+	}
+}
+
+const FItemStatTable* FFrameDataTables::GetItemStats(EItemRarity Rarity) const
+{
+	const int32 Index{ static_cast<int32>(Rarity) };
+	return ItemStatRows.IsValidIndex(Index) ? ItemStatRows[Index] : nullptr;
+}
+
+const FWeaponDataTable* FFrameDataTables::GetWeaponData(EWeaponType WeaponType) const
+{
+	if (WeaponType == EWeaponType::EWT_RocketLauncher && bRocketLauncherStandIn) return &RocketLauncherStandIn;
+
+	const int32 Index{ static_cast<int32>(WeaponType) };
+	return WeaponRows.IsValidIndex(Index) ? WeaponRows[Index] : nullptr;
+}
+
+void UFrameDataRegistry::Deinitialize()
+{
+	for (UDataTable* Table : { DataTables.GetItemStatTable(), DataTables.GetWeaponTable() })
+	{
+		if (Table)
+		{
+			Table->OnDataTableChanged().RemoveAll(this);
+		}
+	}
+
+	Super::Deinitialize();
+}
+
+void UFrameDataRegistry::LoadTables()
+{
+	DataTables.Load();
+
+	//Cached rows are found again whenever a designer edits or reimports a table
+	for (UDataTable* Table : { DataTables.GetItemStatTable(), DataTables.GetWeaponTable() })
+	{
+		if (Table)
+		{
+			Table->OnDataTableChanged().AddUObject(this, &UFrameDataRegistry::OnTableChanged, Table);
+		}
+	}
+}
+
+void UFrameDataRegistry::OnTableChanged(UDataTable* Table)
+{
+	if (DataTables.UsesTable(Table))
+	{
+		DataTables.ResolveRows();
+	}
+}
+
+const FFrameDataTables& UFrameDataRegistry::GetDataTables(const UObject* WorldContextObject)
+{
+	UFrameDataRegistry* Registry = GEngine ? GEngine->GetEngineSubsystem<UFrameDataRegistry>() : nullptr;
+	check(Registry);
+
+	//Loaded on first use rather than at engine start, when the asset registry may not be ready yet
+	if (!Registry->DataTables.IsLoaded())
+	{
+		Registry->LoadTables();
+	}
+	return Registry->DataTables;
+}
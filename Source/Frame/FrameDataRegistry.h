@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "FrameDataRegistry.generated.h"
+
+//Item stat and weapon tables with their rows resolved by enum
+USTRUCT()
+struct FRAME_API FFrameDataTables
+{
+	GENERATED_BODY()
+
+	//Loads both tables and resolves the row for every rarity and weapon type
+	void Load();
+
+	//Finds every row again, called when a table is edited or reimported since that moves its rows
+	void ResolveRows();
+
+	FORCEINLINE bool IsLoaded() const { return bLoaded; }
+	FORCEINLINE bool UsesTable(const UDataTable* Table) const { return Table && (Table == ItemStatTable || Table == WeaponTable); }
+	FORCEINLINE UDataTable* GetItemStatTable() const { return ItemStatTable; }
+	FORCEINLINE UDataTable* GetWeaponTable() const { return WeaponTable; }
+
+	//Null when the table or row is missing. Rows are cached until the table changes,
+	//so don't hold on to them across a table edit
+	const FItemStatTable* GetItemStats(EItemRarity Rarity) const;
+	const FWeaponDataTable* GetWeaponData(EWeaponType WeaponType) const;
+
+private:
+
+	UPROPERTY()
+	UDataTable* ItemStatTable = nullptr;
+
+	UPROPERTY()
+	UDataTable* WeaponTable = nullptr;
+
+	//Indexed by EItemRarity and EWeaponType, null where the table has no row
+	TArray<const FItemStatTable*> ItemStatRows;
+	TArray<const FWeaponDataTable*> WeaponRows;
+
+	//Rocket launcher row built from the assault rifle's when the weapon table has none
+	UPROPERTY()
+	FWeaponDataTable RocketLauncherStandIn;
+
+	bool bRocketLauncherStandIn = false;
+
+	bool bLoaded = false;
+};
+
+/**
+ * Loads the item stat and weapon data tables on first use and hands out rows by enum,
+ * so constructing or spawning items never touches the asset lookup path. Lives with the
+ * engine so editor construction scripts and every game instance share one copy.
+ */
+UCLASS()
+class FRAME_API UFrameDataRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	//Tables shared by the editor and every game instance
+	static const FFrameDataTables& GetDataTables(const UObject* WorldContextObject);
+
+private:
+
+	void LoadTables();
+
+	void OnTableChanged(UDataTable* Table);
+
+	UPROPERTY()
+	FFrameDataTables DataTables;
+};
@@ -2,7 +2,13 @@
 
 
 #include "FrameGameModeBase.h"
+#include "FrameHUD.h"
 
+AFrameGameModeBase::AFrameGameModeBase()
+{
+    //Draws damage numbers
+    HUDClass = AFrameHUD::StaticClass();
+}
 
 void AFrameGameModeBase::PawnKilled(APawn* PawnKilled)
 {
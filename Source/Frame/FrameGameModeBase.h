@@ -15,6 +15,7 @@ class FRAME_API AFrameGameModeBase : public AGameModeBase
 	GENERATED_BODY()
 
 public:
+	AFrameGameModeBase();
 
 	virtual void PawnKilled(APawn* PawnKilled);
 	
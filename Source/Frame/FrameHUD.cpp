@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FrameHUD.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Engine/Font.h"
+#include "GameFramework/PlayerController.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Draw Damage Numbers"), STAT_DrawDamageNumbers, STATGROUP_Frame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers"), STAT_DamageNumbers, STATGROUP_Frame);
+
+AFrameHUD::AFrameHUD() :
+	NextDamageNumber(0),
+	DamageNumberLifetime(1.f),
+	DamageNumberRiseSpeed(60.f),
+	DamageNumberFadeFraction(0.3f),
+	DamageNumberSpread(20.f),
+	DamageNumberFont(nullptr),
+	DamageNumberScale(1.f),
+	HeadshotNumberScale(1.3f),
+	DamageNumberColor(FLinearColor::White),
+	HeadshotNumberColor(FLinearColor(1.f, 0.1f, 0.1f)),
+	LimbNumberColor(FLinearColor(0.7f, 0.7f, 0.7f))
+{
+	DamageNumbers.SetNum(MaxDamageNumbers);
+}
+
+bool AFrameHUD::AddDamageNumber(const UObject* WorldContextObject, int32 Damage, const FVector& WorldLocation, EHitZone HitZone)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	AFrameHUD* FrameHUD = PlayerController ? Cast<AFrameHUD>(PlayerController->GetHUD()) : nullptr;
+	if (FrameHUD)
+	{
+		FrameHUD->AddDamageNumber(Damage, WorldLocation, HitZone);
+		return true;
+	}
+
+	if (PlayerController && PlayerController->GetHUD())
+	{
+		static bool bWarned{ false };
+		if (!bWarned)
+		{
+			bWarned = true;
+			UE_LOG(LogTemp, Warning, TEXT("HUD %s is not an AFrameHUD, damage numbers fall back to enemy hit point widgets"), *PlayerController->GetHUD()->GetClass()->GetName());
+		}
+	}
+	return false;
+}
+
+void AFrameHUD::AddDamageNumber(int32 Damage, const FVector& WorldLocation, EHitZone HitZone)
+{
+	FDamageNumber& DamageNumber = DamageNumbers[NextDamageNumber];
+	DamageNumber.WorldLocation = WorldLocation;
+	DamageNumber.ScreenOffset = FMath::RandPointInCircle(DamageNumberSpread);
+	DamageNumber.SpawnTime = GetWorld()->GetTimeSeconds();
+	DamageNumber.Damage = Damage;
+	DamageNumber.HitZone = HitZone;
+
+	NextDamageNumber = (NextDamageNumber + 1) % MaxDamageNumbers;
+}
+
+void AFrameHUD::DrawHUD()
+{
+	Super::DrawHUD();
+
+	DrawDamageNumbers();
+}
+
+void AFrameHUD::DrawDamageNumbers()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DrawDamageNumbers);
+
+	UFont* Font = DamageNumberFont ? DamageNumberFont : GEngine->GetLargeFont();
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	const float FadeTime{ FMath::Max(DamageNumberLifetime * DamageNumberFadeFraction, KINDA_SMALL_NUMBER) };
+	int32 NumDrawn{ 0 };
+
+	for (FDamageNumber& DamageNumber : DamageNumbers)
+	{
+		if (DamageNumber.SpawnTime < 0.f) continue;
+
+		const float Age{ Now - DamageNumber.SpawnTime };
+		if (Age > DamageNumberLifetime)
+		{
+			DamageNumber.SpawnTime = -1.f;
+			continue;
+		}
+
+		//Z of zero means the location is behind the camera
+		const FVector ScreenLocation{ Project(DamageNumber.WorldLocation + FVector(0.f, 0.f, Age * DamageNumberRiseSpeed)) };
+		if (ScreenLocation.Z <= 0.f) continue;
+
+		FLinearColor Color{ DamageNumberColor };
+		float Scale{ DamageNumberScale };
+		if (DamageNumber.HitZone == EHitZone::EHZ_Head)
+		{
+			Color = HeadshotNumberColor;
+			Scale *= HeadshotNumberScale;
+		}
+		else if (DamageNumber.HitZone == EHitZone::EHZ_Limbs)
+		{
+			Color = LimbNumberColor;
+		}
+		Color.A = FMath::Clamp((DamageNumberLifetime - Age) / FadeTime, 0.f, 1.f);
+
+		const FString Text{ FString::FromInt(DamageNumber.Damage) };
+		float TextWidth;
+		float TextHeight;
+		GetTextSize(Text, TextWidth, TextHeight, Font, Scale);
+		DrawText(Text, Color,
+			ScreenLocation.X + DamageNumber.ScreenOffset.X - TextWidth * 0.5f,
+			ScreenLocation.Y + DamageNumber.ScreenOffset.Y - TextHeight * 0.5f,
+			Font, Scale);
+		NumDrawn++;
+	}
+
+	SET_DWORD_STAT(STAT_DamageNumbers, NumDrawn);
+}
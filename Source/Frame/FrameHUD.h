@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "HitZoneDataAsset.h"
+#include "FrameHUD.generated.h"
+
+//One damage number on screen, slot in the HUD's ring buffer
+struct FDamageNumber
+{
+	FVector WorldLocation;
+	//Pixel offset so numbers from the same spot spread out
+	FVector2D ScreenOffset;
+	//World time the number appeared, negative for a free slot
+	float SpawnTime = -1.f;
+	int32 Damage = 0;
+	EHitZone HitZone = EHitZone::EHZ_Torso;
+};
+
+/**
+ * Draws every damage number straight onto the HUD canvas. Numbers live in a fixed ring buffer,
+ * are projected together once per frame in DrawHUD and expire by age, so automatic fire
+ * into a crowd creates no widgets or timers.
+ */
+UCLASS()
+class FRAME_API AFrameHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	AFrameHUD();
+
+	virtual void DrawHUD() override;
+
+	//Adds a number to the first local player's HUD, false when that HUD is not an AFrameHUD
+	static bool AddDamageNumber(const UObject* WorldContextObject, int32 Damage, const FVector& WorldLocation, EHitZone HitZone);
+
+	//Takes the next slot of the ring buffer, overwriting the oldest number when all are live
+	void AddDamageNumber(int32 Damage, const FVector& WorldLocation, EHitZone HitZone);
+
+private:
+
+	void DrawDamageNumbers();
+
+	static constexpr int32 MaxDamageNumbers{ 128 };
+
+	TArray<FDamageNumber> DamageNumbers;
+
+	//Ring buffer slot written next
+	int32 NextDamageNumber;
+
+	//Seconds a number stays on screen
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	float DamageNumberLifetime;
+
+	//World units per second numbers drift upwards
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	float DamageNumberRiseSpeed;
+
+	//Fraction of the lifetime spent fading out at the end
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	float DamageNumberFadeFraction;
+
+	//Largest random pixel offset given to a new number
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	float DamageNumberSpread;
+
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	class UFont* DamageNumberFont;
+
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	float DamageNumberScale;
+
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	float HeadshotNumberScale;
+
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	FLinearColor DamageNumberColor;
+
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	FLinearColor HeadshotNumberColor;
+
+	UPROPERTY(EditAnywhere, Category = DamageNumbers, meta = (AllowPrivateAccess = "true"))
+	FLinearColor LimbNumberColor;
+};
@@ -0,0 +1,318 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GroundLootSubsystem.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "FrameDataRegistry.h"
+#include "PickupPoolSubsystem.h"
+#include "ItemPulseSubsystem.h"
+#include "InstancedVisuals.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Ground Loot"), STAT_UpdateGroundLoot, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ground Loot Drops"), STAT_GroundLootDrops, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ground Loot Promoted"), STAT_GroundLootPromoted, STATGROUP_Frame);
+
+namespace GroundLootTuning
+{
+	constexpr float CellSize{ 800.f };
+	//Added to the item's pickup radius so the actor exists before the character reaches it
+	constexpr float PromoteMargin{ 150.f };
+	//Demoting further out than promoting stops drops on the edge flipping every update
+	constexpr float DemoteScale{ 1.25f };
+}
+
+UGroundLootSubsystem::UGroundLootSubsystem() :
+	Grid(GroundLootTuning::CellSize),
+	MaxPromoteRadius(0.f),
+	TimeSinceUpdate(0.f)
+{
+}
+
+void UGroundLootSubsystem::Deinitialize()
+{
+	InstancedVisuals::DestroyActor(VisualsActor);
+	Buckets.Empty();
+	Drops.Empty();
+	PromotedDrops.Empty();
+	Grid.Reset();
+
+	Super::Deinitialize();
+}
+
+void UGroundLootSubsystem::DropLoot(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& Transform, EItemRarity Rarity, int32 ItemCount)
+{
+	if (ItemClass == nullptr || WorldContextObject == nullptr) return;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	UGroundLootSubsystem* GroundLoot = World ? World->GetSubsystem<UGroundLootSubsystem>() : nullptr;
+	if (GroundLoot && GroundLoot->AddDrop(ItemClass, Transform, Rarity, ItemCount)) return;
+
+	UPickupPoolSubsystem::SpawnItem(WorldContextObject, ItemClass, Transform, Rarity, ItemCount);
+}
+
+bool UGroundLootSubsystem::AddDrop(TSubclassOf<AItem> ItemClass, const FTransform& Transform, EItemRarity Rarity, int32 ItemCount)
+{
+	const int32 BucketIndex{ GetBucketIndex(ItemClass, Rarity) };
+	if (BucketIndex == INDEX_NONE) return false;
+
+	FGroundLootDrop Drop;
+	Drop.Transform = Transform;
+	Drop.ItemCount = ItemCount;
+	Drop.BucketIndex = BucketIndex;
+	AddInstance(Drops.Add(Drop));
+	return true;
+}
+
+int32 UGroundLootSubsystem::GetBucketIndex(TSubclassOf<AItem> ItemClass, EItemRarity Rarity)
+{
+	if (ItemClass == nullptr) return INDEX_NONE;
+
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); BucketIndex++)
+	{
+		if (Buckets[BucketIndex].ItemClass == ItemClass && Buckets[BucketIndex].Rarity == Rarity) return BucketIndex;
+	}
+
+	const AItem* ItemDefaults = ItemClass->GetDefaultObject<AItem>();
+	UStaticMesh* Mesh = ItemDefaults->GetGroundLootMesh();
+	if (Mesh == nullptr) return INDEX_NONE;
+
+	UHierarchicalInstancedStaticMeshComponent* MeshComponent = InstancedVisuals::AddMeshComponent<UHierarchicalInstancedStaticMeshComponent>(GetWorld(), VisualsActor, Mesh);
+
+	//Primitive data is shared by every instance, so each rarity gets its own component and glow colour
+	const FItemStatTable* StatRow = UFrameDataRegistry::GetDataTables(this).GetItemStats(Rarity);
+	if (StatRow && ItemDefaults->WritePulseData(MeshComponent, StatRow->GlowColor))
+	{
+		MeshComponent->SetCustomPrimitiveDataFloat(ItemPulseData::GlowBlendAlpha, 0.f);
+	}
+
+	FGroundLootBucket Bucket;
+	Bucket.ItemClass = ItemClass;
+	Bucket.Rarity = Rarity;
+	Bucket.MeshComponent = MeshComponent;
+	Bucket.PromoteRadius = ItemDefaults->GetPickupRadius() + GroundLootTuning::PromoteMargin;
+	MaxPromoteRadius = FMath::Max(MaxPromoteRadius, Bucket.PromoteRadius);
+	return Buckets.Add(Bucket);
+}
+
+void UGroundLootSubsystem::AddInstance(int32 DropIndex)
+{
+	FGroundLootDrop& Drop = Drops[DropIndex];
+	FGroundLootBucket& Bucket = Buckets[Drop.BucketIndex];
+
+	Bucket.MeshComponent->AddInstance(Drop.Transform);
+	Drop.InstanceIndex = Bucket.InstanceDrops.Add(DropIndex);
+	Grid.Update(DropIndex, Drop.Transform.GetLocation());
+}
+
+void UGroundLootSubsystem::RemoveInstance(int32 DropIndex)
+{
+	FGroundLootDrop& Drop = Drops[DropIndex];
+	if (Drop.InstanceIndex == INDEX_NONE) return;
+
+	FGroundLootBucket& Bucket = Buckets[Drop.BucketIndex];
+	const int32 LastIndex{ Bucket.InstanceDrops.Num() - 1 };
+
+	//Move the last instance into the freed slot and remove from the end, so no other index shifts
+	if (Drop.InstanceIndex != LastIndex)
+	{
+		const int32 MovedDropIndex{ Bucket.InstanceDrops[LastIndex] };
+		Bucket.MeshComponent->UpdateInstanceTransform(Drop.InstanceIndex, Drops[MovedDropIndex].Transform, true, false, true);
+		Bucket.InstanceDrops[Drop.InstanceIndex] = MovedDropIndex;
+		Drops[MovedDropIndex].InstanceIndex = Drop.InstanceIndex;
+	}
+	Bucket.MeshComponent->RemoveInstance(LastIndex);
+	Bucket.InstanceDrops.Pop(false);
+
+	Drop.InstanceIndex = INDEX_NONE;
+	Grid.Remove(DropIndex);
+}
+
+void UGroundLootSubsystem::PromoteDrop(int32 DropIndex)
+{
+	RemoveInstance(DropIndex);
+
+	FGroundLootDrop& Drop = Drops[DropIndex];
+	const FGroundLootBucket& Bucket = Buckets[Drop.BucketIndex];
+	AItem* Item = UPickupPoolSubsystem::SpawnItem(this, Bucket.ItemClass, Drop.Transform, Bucket.Rarity, Drop.ItemCount);
+	if (Item == nullptr)
+	{
+		Drops.RemoveAt(DropIndex);
+		return;
+	}
+
+	Drop.PromotedItem = Item;
+	PromotedDrops.Add(DropIndex);
+}
+
+void UGroundLootSubsystem::DemoteDrop(int32 DropIndex, AItem* Item)
+{
+	FGroundLootDrop& Drop = Drops[DropIndex];
+	Drop.Transform = Item->GetActorTransform();
+	Drop.ItemCount = Item->GetItemCount();
+	Drop.PromotedItem.Reset();
+
+	UPickupPoolSubsystem::ReleaseItem(this, Item);
+	AddInstance(DropIndex);
+}
+
+void UGroundLootSubsystem::RemoveDrop(int32 DropIndex)
+{
+	RemoveInstance(DropIndex);
+	Drops.RemoveAt(DropIndex);
+}
+
+void UGroundLootSubsystem::Tick(float DeltaTime)
+{
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval || Drops.Num() == 0) return;
+	TimeSinceUpdate = 0.f;
+
+	UpdateDrops();
+}
+
+void UGroundLootSubsystem::UpdateDrops()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UpdateGroundLoot);
+
+	TArray<FVector, TInlineAllocator<4>> CharacterLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			CharacterLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	//Demote drops nobody is near, forget the ones that were collected
+	for (int32 i = PromotedDrops.Num() - 1; i >= 0; i--)
+	{
+		const int32 DropIndex{ PromotedDrops[i] };
+		AItem* Item = Drops[DropIndex].PromotedItem.Get();
+		if (Item == nullptr || Item->GetItemState() != EItemState::EIS_PickUp)
+		{
+			RemoveDrop(DropIndex);
+			PromotedDrops.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		const float DemoteRadius{ Buckets[Drops[DropIndex].BucketIndex].PromoteRadius * GroundLootTuning::DemoteScale };
+		const FVector ItemLocation{ Item->GetActorLocation() };
+		const bool bCharacterNear = CharacterLocations.ContainsByPredicate([&](const FVector& Location)
+		{
+			return FVector::DistSquared(Location, ItemLocation) <= DemoteRadius * DemoteRadius;
+		});
+		if (!bCharacterNear)
+		{
+			DemoteDrop(DropIndex, Item);
+			PromotedDrops.RemoveAtSwap(i, 1, false);
+		}
+	}
+
+	//Promote dormant drops a character walked up to
+	TArray<int32> NearbyDrops;
+	for (const FVector& Location : CharacterLocations)
+	{
+		NearbyDrops.Reset();
+		Grid.Query(Location, MaxPromoteRadius, NearbyDrops);
+		for (const int32 DropIndex : NearbyDrops)
+		{
+			const FGroundLootDrop& Drop = Drops[DropIndex];
+			if (Drop.InstanceIndex == INDEX_NONE) continue;
+
+			const float PromoteRadius{ Buckets[Drop.BucketIndex].PromoteRadius };
+			if (FVector::DistSquared(Location, Drop.Transform.GetLocation()) <= PromoteRadius * PromoteRadius)
+			{
+				PromoteDrop(DropIndex);
+			}
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GroundLootDrops, Drops.Num());
+	SET_DWORD_STAT(STAT_GroundLootPromoted, PromotedDrops.Num());
+}
+
+TStatId UGroundLootSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGroundLootSubsystem, STATGROUP_Tickables);
+}
+
+namespace GroundLootStress
+{
+	constexpr int32 DefaultDropCount{ 5000 };
+	constexpr float DropSpacing{ 150.f };
+	constexpr int32 NumTimedUpdates{ 100 };
+
+	//Scatters drops around the first player, logs the actor count before and after and times the update pass
+	void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		UGroundLootSubsystem* GroundLoot = World ? World->GetSubsystem<UGroundLootSubsystem>() : nullptr;
+		const APawn* Pawn = UGameplayStatics::GetPlayerPawn(World, 0);
+		if (GroundLoot == nullptr || Pawn == nullptr) return;
+
+		const int32 DropCount{ Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : DefaultDropCount };
+
+		//Given class, or every instanceable item class already in the level
+		TArray<TSubclassOf<AItem>> ItemClasses;
+		if (Args.Num() > 1)
+		{
+			ItemClasses.Add(LoadClass<AItem>(nullptr, *Args[1]));
+		}
+		else
+		{
+			for (TActorIterator<AItem> It(World); It; ++It)
+			{
+				if (It->GetGroundLootMesh())
+				{
+					ItemClasses.AddUnique(It->GetClass());
+				}
+			}
+		}
+		ItemClasses.Remove(nullptr);
+		if (ItemClasses.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Ground loot stress: no item class with a ground loot mesh"));
+			return;
+		}
+
+		const int32 ActorsBefore{ World->GetActorCount() };
+		const FVector Center{ Pawn->GetActorLocation() };
+		const float Radius{ FMath::Sqrt(static_cast<float>(DropCount)) * DropSpacing };
+
+		for (int32 i = 0; i < DropCount; i++)
+		{
+			const FVector2D Offset{ FMath::RandPointInCircle(Radius) };
+			const FVector Start{ Center + FVector(Offset, 1000.f) };
+			FHitResult GroundHit;
+			const bool bHitGround = World->LineTraceSingleByChannel(GroundHit, Start, Start - FVector(0.f, 0.f, 3000.f), ECollisionChannel::ECC_Visibility);
+			const FVector Location{ bHitGround ? GroundHit.ImpactPoint : FVector(Start.X, Start.Y, Center.Z) };
+
+			const TSubclassOf<AItem> ItemClass{ ItemClasses[FMath::RandHelper(ItemClasses.Num())] };
+			const EItemRarity Rarity{ static_cast<EItemRarity>(FMath::RandHelper(static_cast<int32>(EItemRarity::EIR_MAX))) };
+			UGroundLootSubsystem::DropLoot(World, ItemClass, FTransform(FRotator(0.f, FMath::FRandRange(0.f, 360.f), 0.f), Location), Rarity, ItemClass->GetDefaultObject<AItem>()->GetItemCount());
+		}
+
+		//First pass promotes what the player stands in, the rest are the steady cost paid every UpdateInterval
+		GroundLoot->UpdateDrops();
+		const double StartTime{ FPlatformTime::Seconds() };
+		for (int32 i = 0; i < NumTimedUpdates; i++)
+		{
+			GroundLoot->UpdateDrops();
+		}
+		const double UpdateMs{ (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumTimedUpdates };
+
+		UE_LOG(LogTemp, Display, TEXT("Ground loot stress: %d drops added, %d ground drops (%d promoted), actors %d -> %d, update pass %.3f ms (average of %d)"),
+			DropCount, GroundLoot->GetNumDrops(), GroundLoot->GetNumPromotedDrops(), ActorsBefore, World->GetActorCount(), UpdateMs, NumTimedUpdates);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GroundLootStressCommand(
+	TEXT("Frame.GroundLootStress"),
+	TEXT("Scatters ground loot around the player and logs actor counts and update cost. Optional drop count (default 5000) and item class path."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&GroundLootStress::Run));
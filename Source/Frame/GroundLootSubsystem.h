@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Item.h"
+#include "SpatialHashGrid.h"
+#include "GroundLootSubsystem.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+
+//Instanced mesh drawing every dormant drop of one item class and rarity
+USTRUCT()
+struct FGroundLootBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AItem> ItemClass;
+
+	EItemRarity Rarity = EItemRarity::EIR_Common;
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* MeshComponent = nullptr;
+
+	//Drop drawn by each instance
+	TArray<int32> InstanceDrops;
+
+	//Characters this close wake the drop up into an actor
+	float PromoteRadius = 0.f;
+};
+
+//One pickup lying on the ground, either an instance or a promoted actor
+struct FGroundLootDrop
+{
+	FTransform Transform;
+	int32 ItemCount = 0;
+	int32 BucketIndex = INDEX_NONE;
+
+	//Index into the bucket's instances while dormant
+	int32 InstanceIndex = INDEX_NONE;
+
+	//Actor standing in for the drop while a character is near
+	TWeakObjectPtr<AItem> PromotedItem;
+};
+
+/**
+ * Keeps mass ground loot as instances of one hierarchical instanced mesh per item class and rarity.
+ * A drop becomes a real item from the pickup pool only while a player character is within its
+ * pickup range, and goes back to being an instance once they walk away without collecting it.
+ */
+UCLASS()
+class FRAME_API UGroundLootSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UGroundLootSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Drops through the world's ground loot, or spawns a pickup if there is none or the class has no ground loot mesh
+	static void DropLoot(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& Transform, EItemRarity Rarity, int32 ItemCount);
+
+	//False if the class has no ground loot mesh
+	bool AddDrop(TSubclassOf<AItem> ItemClass, const FTransform& Transform, EItemRarity Rarity, int32 ItemCount);
+
+	FORCEINLINE int32 GetNumDrops() const { return Drops.Num(); }
+	FORCEINLINE int32 GetNumPromotedDrops() const { return PromotedDrops.Num(); }
+
+	//One promote and demote pass against every player's pawn, run by Tick every UpdateInterval
+	void UpdateDrops();
+
+private:
+
+	//Finds or creates the bucket for class and rarity, INDEX_NONE if the class cannot be instanced
+	int32 GetBucketIndex(TSubclassOf<AItem> ItemClass, EItemRarity Rarity);
+
+	void AddInstance(int32 DropIndex);
+	void RemoveInstance(int32 DropIndex);
+
+	void PromoteDrop(int32 DropIndex);
+	void DemoteDrop(int32 DropIndex, AItem* Item);
+
+	//Forgets a drop whose actor was collected
+	void RemoveDrop(int32 DropIndex);
+
+	TSparseArray<FGroundLootDrop> Drops;
+
+	//Dormant drops by location
+	TSpatialHashGrid<int32> Grid;
+
+	//Drops currently stood in for by an actor
+	TArray<int32> PromotedDrops;
+
+	UPROPERTY()
+	TArray<FGroundLootBucket> Buckets;
+
+	//Actor holding the instanced mesh components
+	UPROPERTY()
+	AActor* VisualsActor = nullptr;
+
+	//Largest promote radius of any bucket, bounds grid queries
+	float MaxPromoteRadius;
+
+	//Seconds between promote and demote passes
+	static constexpr float UpdateInterval{ 0.1f };
+
+	float TimeSinceUpdate;
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitZoneDataAsset.h"
+#include "Components/SkinnedMeshComponent.h"
+
+void UHitZoneDataAsset::ResolveBoneZones(const USkinnedMeshComponent* Mesh, TArray<FResolvedHitZone>& OutBoneZones) const
+{
+	OutBoneZones.Reset();
+	if (Mesh == nullptr) return;
+
+	FResolvedHitZone DefaultHitZone;
+	DefaultHitZone.Zone = DefaultZone;
+	DefaultHitZone.DamageMultiplier = DefaultDamageMultiplier;
+
+	const int32 NumBones = Mesh->GetNumBones();
+	OutBoneZones.Init(DefaultHitZone, NumBones);
+
+	//Reference skeleton stores parents before children, so each bone can copy its parent
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	{
+		const FName BoneName = Mesh->GetBoneName(BoneIndex);
+		const FHitZoneBone* ZoneBone = Bones.FindByPredicate([BoneName](const FHitZoneBone& Entry) { return Entry.BoneName == BoneName; });
+		if (ZoneBone)
+		{
+			OutBoneZones[BoneIndex].Zone = ZoneBone->Zone;
+			OutBoneZones[BoneIndex].DamageMultiplier = ZoneBone->DamageMultiplier;
+			continue;
+		}
+
+		const int32 ParentIndex = Mesh->GetBoneIndex(Mesh->GetParentBone(BoneName));
+		if (ParentIndex != INDEX_NONE && ParentIndex < BoneIndex)
+		{
+			OutBoneZones[BoneIndex] = OutBoneZones[ParentIndex];
+		}
+	}
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "HitZoneDataAsset.generated.h"
+
+UENUM(BlueprintType)
+enum class EHitZone : uint8
+{
+	EHZ_Torso UMETA(DisplayName = "Torso"),
+	EHZ_Head UMETA(DisplayName = "Head"),
+	EHZ_Limbs UMETA(DisplayName = "Limbs"),
+
+	EHZ_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+USTRUCT(BlueprintType)
+struct FHitZoneBone
+{
+	GENERATED_BODY()
+
+	//Bone the zone starts at - child bones inherit it unless listed themselves
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FName BoneName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	EHitZone Zone = EHitZone::EHZ_Torso;
+
+	//Scales the weapon damage for hits in this zone, the head zone uses the weapon's headshot damage instead
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float DamageMultiplier = 1.f;
+};
+
+//Zone and multiplier looked up for a hit body
+struct FResolvedHitZone
+{
+	EHitZone Zone = EHitZone::EHZ_Torso;
+	float DamageMultiplier = 1.f;
+};
+
+/**
+ * Maps bones of an enemy skeleton to hit zones and damage multipliers.
+ * Assigned per enemy class and resolved into a per-body lookup table at BeginPlay.
+ */
+UCLASS(BlueprintType)
+class FRAME_API UHitZoneDataAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	//Zone for bones with no listed ancestor
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hit Zones")
+	EHitZone DefaultZone = EHitZone::EHZ_Torso;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hit Zones")
+	float DefaultDamageMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hit Zones")
+	TArray<FHitZoneBone> Bones;
+
+	//Fills OutBoneZones with one entry per bone of Mesh, indexed by bone index
+	void ResolveBoneZones(const class USkinnedMeshComponent* Mesh, TArray<FResolvedHitZone>& OutBoneZones) const;
+};
@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitscanResolverSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "BulletHitInterface.h"
+#include "Enemy.h"
+#include "FXPoolSubsystem.h"
+#include "DamageQueueSubsystem.h"
+#include "HordeSubsystem.h"
+#include "FrameHUD.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Resolve Hitscan"), STAT_ResolveHitscan, STATGROUP_Frame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Shots"), STAT_HitscanShots, STATGROUP_Frame);
+
+namespace
+{
+	//Outcome of a single muzzle trace
+	struct FResolvedShot
+	{
+		int32 ShotIndex;
+		AActor* HitActor;
+		AActor* Shooter;
+		FHitResult HitResult;
+	};
+}
+
+void UHitscanResolverSubsystem::QueueShot(const FHitscanRequest& Shot)
+{
+	PendingShots.Add(Shot);
+}
+
+void UHitscanResolverSubsystem::Tick(float DeltaTime)
+{
+	if (PendingShots.Num() == 0 && TracedShots.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_ResolveHitscan);
+
+	//Traces launched last frame have finished by now
+	ResolveTracedShots();
+
+	//Take the queue so anything fired while dispatching waits for next frame
+	TracedShots = MoveTemp(PendingShots);
+	PendingShots.Reset();
+	SET_DWORD_STAT(STAT_HitscanShots, TracedShots.Num());
+
+	UWorld* World = GetWorld();
+	TraceHandles.Reset(TracedShots.Num());
+	for (const FHitscanRequest& Shot : TracedShots)
+	{
+		const FVector MuzzleLocation{ Shot.MuzzleTransform.GetLocation() };
+
+		if (Shot.MuzzleFlash)
+		{
+			UFXPoolSubsystem::SpawnEmitter(World, Shot.MuzzleFlash, Shot.MuzzleTransform);
+		}
+
+		//Trace a little past the aim point in case the crosshair trace stopped short
+		const FVector StartToEnd{ Shot.AimLocation - MuzzleLocation };
+		const FVector WeaponTraceEnd{ MuzzleLocation + StartToEnd * 1.25f };
+		TraceHandles.Add(World->AsyncLineTraceByChannel(EAsyncTraceType::Single, MuzzleLocation, WeaponTraceEnd, ECollisionChannel::ECC_Visibility));
+	}
+}
+
+void UHitscanResolverSubsystem::ResolveTracedShots()
+{
+	if (TracedShots.Num() == 0) return;
+
+	UWorld* World = GetWorld();
+	UHordeSubsystem* Horde = World->GetSubsystem<UHordeSubsystem>();
+
+	//Collect every shot whose trace hit something
+	TArray<FResolvedShot> Hits;
+	Hits.Reserve(TracedShots.Num());
+	for (int32 ShotIndex = 0; ShotIndex < TracedShots.Num(); ShotIndex++)
+	{
+		FTraceDatum TraceDatum;
+		if (!World->QueryTraceData(TraceHandles[ShotIndex], TraceDatum)) continue;
+
+		const FHitscanRequest& Shot = TracedShots[ShotIndex];
+		const FHitResult* HitResult = FHitResult::GetFirstBlockingHit(TraceDatum.OutHits);
+
+		//Horde entities are not in the physics scene, a shot passing through one stops there
+		FHordeEntityHit EntityHit;
+		if (Horde && Horde->TraceEntities(TraceDatum.Start, HitResult ? HitResult->Location : TraceDatum.End, EntityHit))
+		{
+			UParticleSystemComponent* EntityBeam = UFXPoolSubsystem::SpawnEmitter(World, Shot.BeamParticles, Shot.MuzzleTransform);
+			if (EntityBeam)
+			{
+				EntityBeam->SetVectorParameter(FName("Target"), EntityHit.Location);
+			}
+			if (Shot.ImpactParticles)
+			{
+				UFXPoolSubsystem::SpawnEmitter(World, Shot.ImpactParticles, EntityHit.Location);
+			}
+
+			//Entities have no bones to find a zone on, every hit is a body hit
+			AFrameHUD::AddDamageNumber(World, FMath::RoundToInt(Shot.Damage), EntityHit.Location, EHitZone::EHZ_Torso);
+			Horde->DamageEntity(EntityHit, Shot.Damage);
+			continue;
+		}
+
+		if (HitResult == nullptr) continue; //Nothing between barrel and beam end
+
+		UParticleSystemComponent* Beam = UFXPoolSubsystem::SpawnEmitter(World, Shot.BeamParticles, Shot.MuzzleTransform);
+		if (Beam)
+		{
+			Beam->SetVectorParameter(FName("Target"), HitResult->Location);
+		}
+
+		Hits.Add({ ShotIndex, HitResult->GetActor(), Shot.Shooter, *HitResult });
+	}
+
+	//Group hits by target then shooter so damage is applied once per pair
+	Hits.Sort([](const FResolvedShot& A, const FResolvedShot& B)
+	{
+		return A.HitActor != B.HitActor ? A.HitActor < B.HitActor : A.Shooter < B.Shooter;
+	});
+
+	for (int32 GroupStart = 0; GroupStart < Hits.Num();)
+	{
+		int32 GroupEnd = GroupStart + 1;
+		while (GroupEnd < Hits.Num() && Hits[GroupEnd].HitActor == Hits[GroupStart].HitActor && Hits[GroupEnd].Shooter == Hits[GroupStart].Shooter)
+		{
+			GroupEnd++;
+		}
+
+		AActor* Target = Hits[GroupStart].HitActor;
+		const FHitscanRequest& Shot = TracedShots[Hits[GroupStart].ShotIndex];
+		const FHitResult& LastHit = Hits[GroupEnd - 1].HitResult;
+
+		if (Target == nullptr)
+		{
+			//No actor to react, spawn default particles for every impact
+			for (int32 i = GroupStart; i < GroupEnd; i++)
+			{
+				const FHitscanRequest& MissedShot = TracedShots[Hits[i].ShotIndex];
+				if (MissedShot.ImpactParticles)
+				{
+					UFXPoolSubsystem::SpawnEmitter(World, MissedShot.ImpactParticles, Hits[i].HitResult.Location);
+				}
+			}
+		}
+		else if (IsValid(Target))
+		{
+			//Impact sound and particles for every bullet, stopping if a hit destroys the target
+			IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(Target);
+			if (BulletHitInterface)
+			{
+				for (int32 i = GroupStart; i < GroupEnd && IsValid(Target); i++)
+				{
+					BulletHitInterface->BulletHit_Implementation(Hits[i].HitResult, Shot.Shooter, Shot.InstigatorController);
+				}
+			}
+
+			AEnemy* HitEnemy = Cast<AEnemy>(Target);
+			if (HitEnemy && IsValid(HitEnemy))
+			{
+				//Sum every bullet this shooter landed on the enemy this frame
+				float ZoneDamage{ 0.f };
+				EHitZone ShownZone{ EHitZone::EHZ_Torso };
+				for (int32 i = GroupStart; i < GroupEnd; i++)
+				{
+					const FHitscanRequest& EnemyShot = TracedShots[Hits[i].ShotIndex];
+					const FResolvedHitZone HitZone{ HitEnemy->GetHitZone(Hits[i].HitResult) };
+					if (ShownZone != EHitZone::EHZ_Head)
+					{
+						//Head takes priority, otherwise show the latest zone
+						ShownZone = HitZone.Zone;
+					}
+
+					//Headshot damage is the whole head bonus, zone multipliers only scale body hits
+					if (HitZone.Zone == EHitZone::EHZ_Head)
+					{
+						ZoneDamage += EnemyShot.HeadshotDamage;
+					}
+					else
+					{
+						ZoneDamage += EnemyShot.Damage * HitZone.DamageMultiplier;
+					}
+				}
+				const int32 Damage{ FMath::RoundToInt(ZoneDamage) };
+
+				UDamageQueueSubsystem::QueueDamage(World, HitEnemy, Damage, Shot.InstigatorController, Shot.Shooter);
+				if (!AFrameHUD::AddDamageNumber(World, Damage, LastHit.Location, ShownZone))
+				{
+					//HUD can't draw numbers, so the enemy Blueprint's widget shows it
+					HitEnemy->ShowHitPoint(Damage, LastHit.Location, ShownZone == EHitZone::EHZ_Head);
+				}
+			}
+		}
+
+		GroupStart = GroupEnd;
+	}
+
+	TracedShots.Reset();
+	TraceHandles.Reset();
+}
+
+TStatId UHitscanResolverSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanResolverSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "HitscanResolverSubsystem.generated.h"
+
+//Single shot waiting to be resolved at the end of the frame
+USTRUCT()
+struct FHitscanRequest
+{
+	GENERATED_BODY()
+
+	//Actor that fired - passed on as damage causer
+	UPROPERTY()
+	AActor* Shooter = nullptr;
+
+	//Controller credited with the damage
+	UPROPERTY()
+	AController* InstigatorController = nullptr;
+
+	//Barrel socket transform when the shot was fired
+	UPROPERTY()
+	FTransform MuzzleTransform;
+
+	//Point under the crosshairs the shot is aimed at
+	UPROPERTY()
+	FVector AimLocation = FVector(0.f);
+
+	//Damage for body and head hits
+	UPROPERTY()
+	float Damage = 0.f;
+
+	UPROPERTY()
+	float HeadshotDamage = 0.f;
+
+	//Particles spawned at the barrel
+	UPROPERTY()
+	UParticleSystem* MuzzleFlash = nullptr;
+
+	//Bullet smoke trail from barrel to impact
+	UPROPERTY()
+	UParticleSystem* BeamParticles = nullptr;
+
+	//Particles spawned when hitting something that isn't an actor
+	UPROPERTY()
+	UParticleSystem* ImpactParticles = nullptr;
+};
+
+/**
+ * Collects every hitscan shot fired during the frame and launches one async muzzle trace per shot
+ * after actors and timers have ticked. The traces run alongside the rest of the frame and are resolved
+ * on the next one: results sorted by target, impact FX per bullet, then damage summed and dispatched
+ * once per target and shooter.
+ */
+UCLASS()
+class FRAME_API UHitscanResolverSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Called by weapon holders instead of tracing and applying damage themselves
+	void QueueShot(const FHitscanRequest& Shot);
+
+	FORCEINLINE int32 GetNumPendingShots() const { return PendingShots.Num(); }
+
+private:
+
+	//Applies the results of last frame's traces
+	void ResolveTracedShots();
+
+	//Shots fired this frame, traced in Tick
+	UPROPERTY()
+	TArray<FHitscanRequest> PendingShots;
+
+	//Shots whose async traces are in flight, with the handle of each
+	UPROPERTY()
+	TArray<FHitscanRequest> TracedShots;
+
+	TArray<FTraceHandle> TraceHandles;
+};
@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HordeSettings.h"
+
+UHordeSettings::UHordeSettings() :
+	PromoteRadius(2500.f),
+	DemoteRadius(3200.f),
+	AggroRadius(6000.f),
+	PatrolArrivalRadius(100.f),
+	PatrolSpeedScale(0.5f),
+	MaxPromotedEnemies(40),
+	MaxPromotionsPerFrame(4)
+{
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "HordeSettings.generated.h"
+
+/**
+ * Radii and budgets for the horde subsystem, editable under Project Settings > Game > Horde
+ * and saved to DefaultGame.ini.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Horde"))
+class FRAME_API UHordeSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UHordeSettings();
+
+	virtual FName GetCategoryName() const override { return FName("Game"); }
+
+	//Entities this close to a player pawn become real enemies
+	UPROPERTY(Config, EditAnywhere, Category = Horde, meta = (ClampMin = "0.0"))
+	float PromoteRadius;
+
+	//Promoted enemies further than this from every player pawn go back to being entities, keep above PromoteRadius
+	UPROPERTY(Config, EditAnywhere, Category = Horde, meta = (ClampMin = "0.0"))
+	float DemoteRadius;
+
+	//Entities this close to a player pawn start chasing it
+	UPROPERTY(Config, EditAnywhere, Category = Horde, meta = (ClampMin = "0.0"))
+	float AggroRadius;
+
+	//Distance at which a patrolling entity turns for its other patrol point
+	UPROPERTY(Config, EditAnywhere, Category = Horde, meta = (ClampMin = "0.0"))
+	float PatrolArrivalRadius;
+
+	//Fraction of the enemy's walk speed used while patrolling
+	UPROPERTY(Config, EditAnywhere, Category = Horde, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float PatrolSpeedScale;
+
+	//Promoted enemies alive at once, entities beyond this wait at the promote radius
+	UPROPERTY(Config, EditAnywhere, Category = Horde, meta = (ClampMin = "0"))
+	int32 MaxPromotedEnemies;
+
+	//Actors spawned per frame, spreads the cost when a crowd reaches the player together
+	UPROPERTY(Config, EditAnywhere, Category = Horde, meta = (ClampMin = "1"))
+	int32 MaxPromotionsPerFrame;
+};
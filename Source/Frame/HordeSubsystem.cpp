@@ -0,0 +1,456 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HordeSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "HordeSettings.h"
+#include "EnemyPoolSubsystem.h"
+#include "Enemy.h"
+#include "InstancedVisuals.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Horde"), STAT_UpdateHorde, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Horde Entities"), STAT_HordeEntities, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Horde Promoted"), STAT_HordePromoted, STATGROUP_Frame);
+
+namespace
+{
+	//Squared distance to the closest player pawn, and that pawn
+	float ClosestPlayer(const TArray<APawn*>& Players, const FVector& Location, APawn*& OutPlayer)
+	{
+		float ClosestDistanceSquared{ TNumericLimits<float>::Max() };
+		OutPlayer = nullptr;
+		for (APawn* Player : Players)
+		{
+			const float DistanceSquared{ FVector::DistSquared2D(Player->GetActorLocation(), Location) };
+			if (DistanceSquared < ClosestDistanceSquared)
+			{
+				ClosestDistanceSquared = DistanceSquared;
+				OutPlayer = Player;
+			}
+		}
+		return ClosestDistanceSquared;
+	}
+}
+
+void UHordeSubsystem::Deinitialize()
+{
+	InstancedVisuals::DestroyActor(VisualsActor);
+	Archetypes.Empty();
+	PromotedEnemies.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHordeSubsystem::SpawnHorde(const UObject* WorldContextObject, TSubclassOf<AEnemy> EnemyClass, const FVector& Center, float Radius, int32 Count)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (World == nullptr || EnemyClass == nullptr) return;
+
+	UHordeSubsystem* Horde = World->GetSubsystem<UHordeSubsystem>();
+	for (int32 i = 0; i < Count; i++)
+	{
+		const FVector Location{ Center + FVector(FMath::RandPointInCircle(Radius), 0.f) };
+		if (Horde && Horde->AddEntity(EnemyClass, Location)) continue;
+
+		UEnemyPoolSubsystem::SpawnEnemy(World, EnemyClass, FTransform(FRotator(0.f, FMath::FRandRange(0.f, 360.f), 0.f), Location));
+	}
+}
+
+bool UHordeSubsystem::AddEntity(TSubclassOf<AEnemy> EnemyClass, const FVector& Location, AActor* Owner)
+{
+	const int32 ArchetypeIndex{ GetArchetypeIndex(EnemyClass) };
+	if (ArchetypeIndex == INDEX_NONE) return false;
+
+	//Same local patrol points a placed enemy of the class would use
+	const AEnemy* EnemyDefaults = EnemyClass->GetDefaultObject<AEnemy>();
+	AddEntity(ArchetypeIndex, Location, FVector::ZeroVector, Archetypes[ArchetypeIndex].MaxHealth, nullptr, Owner,
+		Location + EnemyDefaults->GetPatrolPoint(), Location + EnemyDefaults->GetPatrolPoint2());
+	return true;
+}
+
+bool UHordeSubsystem::TraceEntities(const FVector& Start, const FVector& End, FHordeEntityHit& OutHit) const
+{
+	OutHit.ArchetypeIndex = INDEX_NONE;
+	OutHit.Distance = TNumericLimits<float>::Max();
+
+	for (int32 ArchetypeIndex = 0; ArchetypeIndex < Archetypes.Num(); ArchetypeIndex++)
+	{
+		const FHordeArchetype& Archetype = Archetypes[ArchetypeIndex];
+		const float RadiusSquared{ FMath::Square(Archetype.CapsuleRadius) };
+		const FVector AxisExtent{ 0.f, 0.f, FMath::Max(Archetype.CapsuleHalfHeight - Archetype.CapsuleRadius, 0.f) };
+
+		for (int32 i = 0; i < Archetype.Locations.Num(); i++)
+		{
+			//Closest approach between the segment and the capsule's axis
+			FVector SegmentPoint;
+			FVector AxisPoint;
+			FMath::SegmentDistToSegmentSafe(Start, End, Archetype.Locations[i] - AxisExtent, Archetype.Locations[i] + AxisExtent, SegmentPoint, AxisPoint);
+			if (FVector::DistSquared(SegmentPoint, AxisPoint) > RadiusSquared) continue;
+
+			const float Distance{ FVector::Dist(Start, SegmentPoint) };
+			if (Distance < OutHit.Distance)
+			{
+				OutHit.ArchetypeIndex = ArchetypeIndex;
+				OutHit.EntityIndex = i;
+				OutHit.Location = SegmentPoint;
+				OutHit.Distance = Distance;
+			}
+		}
+	}
+	return OutHit.ArchetypeIndex != INDEX_NONE;
+}
+
+void UHordeSubsystem::DamageEntity(const FHordeEntityHit& Hit, float Damage)
+{
+	if (!Archetypes.IsValidIndex(Hit.ArchetypeIndex) || !Archetypes[Hit.ArchetypeIndex].Health.IsValidIndex(Hit.EntityIndex)) return;
+
+	float& Health = Archetypes[Hit.ArchetypeIndex].Health[Hit.EntityIndex];
+	Health -= Damage;
+	if (Health > 0.f) return;
+
+	AActor* Owner = Archetypes[Hit.ArchetypeIndex].Owners[Hit.EntityIndex].Get();
+	RemoveEntity(Hit.ArchetypeIndex, Hit.EntityIndex);
+	OnHordeEnemyKilled.Broadcast(Owner, nullptr);
+}
+
+void UHordeSubsystem::DamageEntitiesInRadius(const FVector& Origin, float Radius, float Damage)
+{
+	for (int32 ArchetypeIndex = 0; ArchetypeIndex < Archetypes.Num(); ArchetypeIndex++)
+	{
+		//Reach the capsule surface rather than its center, as the physics overlap would
+		const float ReachSquared{ FMath::Square(Radius + Archetypes[ArchetypeIndex].CapsuleRadius) };
+
+		//Backwards so a removed entity's slot is refilled by one already tested
+		for (int32 i = Archetypes[ArchetypeIndex].Locations.Num() - 1; i >= 0; i--)
+		{
+			if (FVector::DistSquared(Archetypes[ArchetypeIndex].Locations[i], Origin) > ReachSquared) continue;
+
+			FHordeEntityHit Hit;
+			Hit.ArchetypeIndex = ArchetypeIndex;
+			Hit.EntityIndex = i;
+			DamageEntity(Hit, Damage);
+		}
+	}
+}
+
+int32 UHordeSubsystem::GetNumEntities() const
+{
+	int32 NumEntities{ 0 };
+	for (const FHordeArchetype& Archetype : Archetypes)
+	{
+		NumEntities += Archetype.Locations.Num();
+	}
+	return NumEntities;
+}
+
+int32 UHordeSubsystem::GetNumEntities(const AActor* Owner) const
+{
+	int32 NumEntities{ 0 };
+	for (const FHordeArchetype& Archetype : Archetypes)
+	{
+		for (const TWeakObjectPtr<AActor>& EntityOwner : Archetype.Owners)
+		{
+			if (EntityOwner.Get() == Owner)
+			{
+				NumEntities++;
+			}
+		}
+	}
+	for (const FHordePromotedEnemy& Promoted : PromotedEnemies)
+	{
+		const AEnemy* Enemy = Promoted.Enemy.Get();
+		if (Promoted.Owner.Get() == Owner && Enemy && !Enemy->IsDying())
+		{
+			NumEntities++;
+		}
+	}
+	return NumEntities;
+}
+
+int32 UHordeSubsystem::GetArchetypeIndex(TSubclassOf<AEnemy> EnemyClass)
+{
+	if (EnemyClass == nullptr) return INDEX_NONE;
+
+	for (int32 ArchetypeIndex = 0; ArchetypeIndex < Archetypes.Num(); ArchetypeIndex++)
+	{
+		if (Archetypes[ArchetypeIndex].EnemyClass == EnemyClass) return ArchetypeIndex;
+	}
+
+	const AEnemy* EnemyDefaults = EnemyClass->GetDefaultObject<AEnemy>();
+	UStaticMesh* Mesh = EnemyDefaults->GetHordeMesh();
+	if (Mesh == nullptr) return INDEX_NONE;
+
+	//Plain instanced mesh rather than hierarchical, every instance moves every frame and a cluster tree would be rebuilt constantly
+	UInstancedStaticMeshComponent* MeshComponent = InstancedVisuals::AddMeshComponent(GetWorld(), VisualsActor, Mesh);
+	MeshComponent->SetCastShadow(false);
+
+	FHordeArchetype Archetype;
+	Archetype.EnemyClass = EnemyClass;
+	Archetype.MeshComponent = MeshComponent;
+	Archetype.MaxSpeed = EnemyDefaults->GetCharacterMovement()->MaxWalkSpeed;
+	Archetype.MaxHealth = EnemyDefaults->GetMaxHealth();
+	//Placed where the skeletal mesh sits on the actor, so the swap on promotion lines up
+	Archetype.MeshOffset = EnemyDefaults->GetMesh()->GetRelativeTransform();
+	Archetype.CapsuleRadius = EnemyDefaults->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	Archetype.CapsuleHalfHeight = EnemyDefaults->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	return Archetypes.Add(Archetype);
+}
+
+int32 UHordeSubsystem::AddEntity(int32 ArchetypeIndex, const FVector& Location, const FVector& Velocity, float Health, AActor* Target, AActor* Owner, const FVector& PatrolPoint, const FVector& PatrolPoint2)
+{
+	FHordeArchetype& Archetype = Archetypes[ArchetypeIndex];
+	Archetype.Locations.Add(Location);
+	Archetype.Velocities.Add(Velocity);
+	Archetype.Health.Add(Health);
+	Archetype.Targets.Add(Target);
+	Archetype.Owners.Add(Owner);
+	Archetype.PatrolPoints.Add(PatrolPoint);
+	Archetype.PatrolPoints2.Add(PatrolPoint2);
+	Archetype.PatrolLegs.Add(false);
+
+	const FRotator Facing{ 0.f, Velocity.IsNearlyZero() ? 0.f : Velocity.Rotation().Yaw, 0.f };
+	const FTransform InstanceTransform{ Archetype.MeshOffset * FTransform(Facing, Location) };
+	Archetype.InstanceTransforms.Add(InstanceTransform);
+	return Archetype.MeshComponent->AddInstance(InstanceTransform, true);
+}
+
+void UHordeSubsystem::RemoveEntity(int32 ArchetypeIndex, int32 EntityIndex)
+{
+	FHordeArchetype& Archetype = Archetypes[ArchetypeIndex];
+	const int32 LastIndex{ Archetype.Locations.Num() - 1 };
+
+	if (EntityIndex != LastIndex)
+	{
+		Archetype.MeshComponent->UpdateInstanceTransform(EntityIndex, Archetype.InstanceTransforms[LastIndex], true, false, true);
+	}
+	Archetype.MeshComponent->RemoveInstance(LastIndex);
+
+	Archetype.Locations.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.Velocities.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.Health.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.Targets.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.Owners.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.PatrolPoints.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.PatrolPoints2.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.PatrolLegs.RemoveAtSwap(EntityIndex, 1, false);
+	Archetype.InstanceTransforms.RemoveAtSwap(EntityIndex, 1, false);
+}
+
+void UHordeSubsystem::Tick(float DeltaTime)
+{
+	if (Archetypes.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_UpdateHorde);
+
+	const UHordeSettings* Settings = GetDefault<UHordeSettings>();
+
+	TArray<APawn*> Players;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			Players.Add(Pawn);
+		}
+	}
+
+	//Fold enemies nobody is near back into entities, forget the ones that died
+	for (int32 i = PromotedEnemies.Num() - 1; i >= 0; i--)
+	{
+		const FHordePromotedEnemy& Promoted = PromotedEnemies[i];
+		AEnemy* Enemy = Promoted.Enemy.Get();
+		if (Enemy == nullptr || Enemy->IsDying())
+		{
+			PromotedEnemies.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		APawn* ClosestPawn;
+		const float DistanceSquared{ ClosestPlayer(Players, Enemy->GetActorLocation(), ClosestPawn) };
+		if (DistanceSquared > FMath::Square(Settings->DemoteRadius) && !Enemy->IsInCombat())
+		{
+			DemoteEnemy(Promoted);
+			PromotedEnemies.RemoveAtSwap(i, 1, false);
+		}
+	}
+
+	int32 PromotionBudget{ FMath::Min(Settings->MaxPromotionsPerFrame, Settings->MaxPromotedEnemies - PromotedEnemies.Num()) };
+	for (int32 ArchetypeIndex = 0; ArchetypeIndex < Archetypes.Num(); ArchetypeIndex++)
+	{
+		SimulateArchetype(ArchetypeIndex, DeltaTime, Players, PromotionBudget);
+	}
+
+	SET_DWORD_STAT(STAT_HordeEntities, GetNumEntities());
+	SET_DWORD_STAT(STAT_HordePromoted, PromotedEnemies.Num());
+}
+
+void UHordeSubsystem::SimulateArchetype(int32 ArchetypeIndex, float DeltaTime, const TArray<APawn*>& Players, int32& PromotionBudget)
+{
+	FHordeArchetype& Archetype = Archetypes[ArchetypeIndex];
+	if (Archetype.Locations.Num() == 0) return;
+
+	const UHordeSettings* Settings = GetDefault<UHordeSettings>();
+	const float AggroRadiusSquared{ FMath::Square(Settings->AggroRadius) };
+	const float PromoteRadiusSquared{ FMath::Square(Settings->PromoteRadius) };
+	const float ArrivalRadiusSquared{ FMath::Square(Settings->PatrolArrivalRadius) };
+	const float PatrolSpeed{ Archetype.MaxSpeed * Settings->PatrolSpeedScale };
+
+	//Backwards so a promoted entity's slot is refilled by one already simulated
+	for (int32 i = Archetype.Locations.Num() - 1; i >= 0; i--)
+	{
+		FVector& Location = Archetype.Locations[i];
+
+		APawn* ClosestPawn;
+		const float DistanceSquared{ ClosestPlayer(Players, Location, ClosestPawn) };
+
+		if (DistanceSquared <= PromoteRadiusSquared && PromotionBudget > 0)
+		{
+			PromotionBudget--;
+			if (PromoteEntity(ArchetypeIndex, i)) continue;
+		}
+
+		if (!Archetype.Targets[i].IsValid() && DistanceSquared <= AggroRadiusSquared)
+		{
+			Archetype.Targets[i] = ClosestPawn;
+		}
+
+		FVector& Velocity = Archetype.Velocities[i];
+		if (const AActor* Target = Archetype.Targets[i].Get())
+		{
+			Velocity = (Target->GetActorLocation() - Location).GetSafeNormal2D() * Archetype.MaxSpeed;
+		}
+		else
+		{
+			const FVector& PatrolGoal = Archetype.PatrolLegs[i] ? Archetype.PatrolPoints2[i] : Archetype.PatrolPoints[i];
+			if (FVector::DistSquared2D(PatrolGoal, Location) <= ArrivalRadiusSquared)
+			{
+				Archetype.PatrolLegs[i] = !Archetype.PatrolLegs[i];
+			}
+			Velocity = (PatrolGoal - Location).GetSafeNormal2D() * PatrolSpeed;
+		}
+
+		//Standing still keeps the last facing
+		if (Velocity.IsNearlyZero()) continue;
+
+		Location += Velocity * DeltaTime;
+		Archetype.InstanceTransforms[i] = Archetype.MeshOffset * FTransform(FRotator(0.f, Velocity.Rotation().Yaw, 0.f), Location);
+	}
+
+	//One render update for the whole class
+	Archetype.MeshComponent->BatchUpdateInstancesTransforms(0, Archetype.InstanceTransforms, true, true, false);
+}
+
+bool UHordeSubsystem::PromoteEntity(int32 ArchetypeIndex, int32 EntityIndex)
+{
+	FHordeArchetype& Archetype = Archetypes[ArchetypeIndex];
+	const FVector Velocity{ Archetype.Velocities[EntityIndex] };
+	const FRotator Facing{ 0.f, Velocity.IsNearlyZero() ? 0.f : Velocity.Rotation().Yaw, 0.f };
+
+	AEnemy* Enemy = UEnemyPoolSubsystem::SpawnEnemy(this, Archetype.EnemyClass, FTransform(Facing, Archetype.Locations[EntityIndex]));
+	if (Enemy == nullptr) return false;
+
+	Enemy->SetHordeState(Archetype.Health[EntityIndex], Archetype.Targets[EntityIndex].Get(), Velocity);
+	//Cleared with the rest of the enemy's bindings when it is demoted back into the pool
+	Enemy->OnEnemyDied.AddUObject(this, &UHordeSubsystem::OnPromotedEnemyDied);
+
+	FHordePromotedEnemy Promoted;
+	Promoted.Enemy = Enemy;
+	Promoted.ArchetypeIndex = ArchetypeIndex;
+	Promoted.Owner = Archetype.Owners[EntityIndex];
+	Promoted.PatrolPoint = Archetype.PatrolPoints[EntityIndex];
+	Promoted.PatrolPoint2 = Archetype.PatrolPoints2[EntityIndex];
+	PromotedEnemies.Add(Promoted);
+
+	RemoveEntity(ArchetypeIndex, EntityIndex);
+	return true;
+}
+
+void UHordeSubsystem::DemoteEnemy(const FHordePromotedEnemy& Promoted)
+{
+	AEnemy* Enemy = Promoted.Enemy.Get();
+	AddEntity(Promoted.ArchetypeIndex, Enemy->GetActorLocation(), Enemy->GetVelocity(), Enemy->GetHealth(), Enemy->GetTarget(),
+		Promoted.Owner.Get(), Promoted.PatrolPoint, Promoted.PatrolPoint2);
+	UEnemyPoolSubsystem::ReleaseEnemy(this, Enemy);
+}
+
+void UHordeSubsystem::OnPromotedEnemyDied(AEnemy* Enemy)
+{
+	const int32 PromotedIndex{ PromotedEnemies.IndexOfByPredicate([Enemy](const FHordePromotedEnemy& Promoted) { return Promoted.Enemy.Get() == Enemy; }) };
+	if (PromotedIndex == INDEX_NONE) return;
+
+	AActor* Owner = PromotedEnemies[PromotedIndex].Owner.Get();
+	PromotedEnemies.RemoveAtSwap(PromotedIndex, 1, false);
+	OnHordeEnemyKilled.Broadcast(Owner, Enemy);
+}
+
+TStatId UHordeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHordeSubsystem, STATGROUP_Tickables);
+}
+
+namespace HordeStress
+{
+	constexpr int32 DefaultEnemyCount{ 2000 };
+	constexpr float EnemySpacing{ 200.f };
+
+	//Scatters a horde around the first player and logs how much of it became actors
+	void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		UHordeSubsystem* Horde = World ? World->GetSubsystem<UHordeSubsystem>() : nullptr;
+		const APawn* Pawn = UGameplayStatics::GetPlayerPawn(World, 0);
+		if (Horde == nullptr || Pawn == nullptr) return;
+
+		const int32 EnemyCount{ Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : DefaultEnemyCount };
+
+		//Given class, or the first enemy class in the level with a horde mesh
+		UClass* EnemyClass{ nullptr };
+		if (Args.Num() > 1)
+		{
+			EnemyClass = LoadClass<AEnemy>(nullptr, *Args[1]);
+		}
+		else
+		{
+			for (TActorIterator<AEnemy> It(World); It && EnemyClass == nullptr; ++It)
+			{
+				if (It->GetHordeMesh())
+				{
+					EnemyClass = It->GetClass();
+				}
+			}
+		}
+		if (EnemyClass == nullptr || EnemyClass->GetDefaultObject<AEnemy>()->GetHordeMesh() == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Horde stress: no enemy class with a horde mesh"));
+			return;
+		}
+
+		//Keep the disc clear of the promote radius so the first frame does not promote a crowd
+		const float InnerRadius{ GetDefault<UHordeSettings>()->DemoteRadius };
+		const float Radius{ InnerRadius + FMath::Sqrt(static_cast<float>(EnemyCount)) * EnemySpacing };
+		const FVector Center{ Pawn->GetActorLocation() };
+
+		const int32 ActorsBefore{ World->GetActorCount() };
+		for (int32 i = 0; i < EnemyCount; i++)
+		{
+			const float Angle{ FMath::FRandRange(0.f, 2.f * PI) };
+			const float Distance{ FMath::Sqrt(FMath::FRandRange(FMath::Square(InnerRadius / Radius), 1.f)) * Radius };
+			Horde->AddEntity(EnemyClass, Center + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.f));
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("Horde stress: %d entities, %d promoted, actors %d -> %d. Watch 'stat Frame' and 'stat Unit' as they close in"),
+			Horde->GetNumEntities(), Horde->GetNumPromoted(), ActorsBefore, World->GetActorCount());
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs HordeStressCommand(
+	TEXT("Frame.HordeStress"),
+	TEXT("Adds a horde of entities around the player. Optional enemy count (default 2000) and enemy class path."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&HordeStress::Run));
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HordeSubsystem.generated.h"
+
+class AEnemy;
+class UInstancedStaticMeshComponent;
+
+//Owner the entity was spawned for, and the promoted enemy if it died as an actor rather than as an entity
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnHordeEnemyKilled, AActor*, AEnemy*);
+
+//Every entity of one enemy class, one array per field so the simulation walks memory in order
+USTRUCT()
+struct FHordeArchetype
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AEnemy> EnemyClass;
+
+	//Draws entity i as instance i
+	UPROPERTY()
+	UInstancedStaticMeshComponent* MeshComponent = nullptr;
+
+	//Class defaults read once when the archetype is made
+	float MaxSpeed = 0.f;
+	float MaxHealth = 0.f;
+	FTransform MeshOffset;
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> Health;
+	TArray<TWeakObjectPtr<AActor>> Targets;
+	//Spawner or other actor that added the entity, kept through promotion and demotion
+	TArray<TWeakObjectPtr<AActor>> Owners;
+	TArray<FVector> PatrolPoints;
+	TArray<FVector> PatrolPoints2;
+	//True while heading for the second patrol point
+	TArray<bool> PatrolLegs;
+
+	//Scratch for the batched instance update
+	TArray<FTransform> InstanceTransforms;
+};
+
+//Enemy actor standing in for an entity near a player
+struct FHordePromotedEnemy
+{
+	TWeakObjectPtr<AEnemy> Enemy;
+	int32 ArchetypeIndex = INDEX_NONE;
+	TWeakObjectPtr<AActor> Owner;
+
+	//Entity patrol route, given back on demotion
+	FVector PatrolPoint;
+	FVector PatrolPoint2;
+};
+
+//Entity a trace passed through
+struct FHordeEntityHit
+{
+	int32 ArchetypeIndex = INDEX_NONE;
+	int32 EntityIndex = INDEX_NONE;
+	FVector Location;
+	float Distance = 0.f;
+};
+
+/**
+ * Simulates distant enemies as plain data: location, velocity, target, patrol route and health per entity,
+ * moved by a seek or patrol step and drawn through one instanced mesh per enemy class. Entities inside
+ * the promote radius of a player pawn are swapped for real AEnemy actors carrying their state, and
+ * enemies that fall behind outside the demote radius are folded back into entities.
+ *
+ * Entities have no physics bodies. Hitscan shots, projectiles and explosions test them against their class
+ * capsule through TraceEntities and DamageEntitiesInRadius, a linear pass over every entity per query.
+ * Anything else that only queries the physics scene (melee swings, sight traces, character movement) passes
+ * through them, and an entity killed as data drops no loot and leaves no corpse.
+ */
+UCLASS()
+class FRAME_API UHordeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Scatters entities in a disc, spawning enemies directly if the world has no horde or the class has no horde mesh
+	static void SpawnHorde(const UObject* WorldContextObject, TSubclassOf<AEnemy> EnemyClass, const FVector& Center, float Radius, int32 Count);
+
+	//False if the class has no horde mesh
+	bool AddEntity(TSubclassOf<AEnemy> EnemyClass, const FVector& Location, AActor* Owner = nullptr);
+
+	//Closest entity whose capsule the segment passes through
+	bool TraceEntities(const FVector& Start, const FVector& End, FHordeEntityHit& OutHit) const;
+
+	//Removes the entity once its health runs out. Invalidates entity indices from earlier traces
+	void DamageEntity(const FHordeEntityHit& Hit, float Damage);
+
+	void DamageEntitiesInRadius(const FVector& Origin, float Radius, float Damage);
+
+	int32 GetNumEntities() const;
+
+	//Entities and living promoted enemies added for one owner
+	int32 GetNumEntities(const AActor* Owner) const;
+
+	FOnHordeEnemyKilled OnHordeEnemyKilled;
+
+	FORCEINLINE int32 GetNumPromoted() const { return PromotedEnemies.Num(); }
+
+private:
+
+	//Finds or creates the archetype for a class, INDEX_NONE if the class cannot be instanced
+	int32 GetArchetypeIndex(TSubclassOf<AEnemy> EnemyClass);
+
+	int32 AddEntity(int32 ArchetypeIndex, const FVector& Location, const FVector& Velocity, float Health, AActor* Target, AActor* Owner, const FVector& PatrolPoint, const FVector& PatrolPoint2);
+
+	//Swaps the last entity into the freed slot so instance indices keep matching entity indices
+	void RemoveEntity(int32 ArchetypeIndex, int32 EntityIndex);
+
+	//Seek or patrol step for every entity, promoting those that reach a player
+	void SimulateArchetype(int32 ArchetypeIndex, float DeltaTime, const TArray<APawn*>& Players, int32& PromotionBudget);
+
+	bool PromoteEntity(int32 ArchetypeIndex, int32 EntityIndex);
+	void DemoteEnemy(const FHordePromotedEnemy& Promoted);
+
+	void OnPromotedEnemyDied(AEnemy* Enemy);
+
+	UPROPERTY()
+	TArray<FHordeArchetype> Archetypes;
+
+	TArray<FHordePromotedEnemy> PromotedEnemies;
+
+	//Actor holding the instanced mesh components
+	UPROPERTY()
+	AActor* VisualsActor = nullptr;
+};
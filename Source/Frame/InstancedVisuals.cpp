@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InstancedVisuals.h"
+#include "Engine/World.h"
+
+AActor* InstancedVisuals::GetOrSpawnActor(UWorld* World, AActor*& VisualsActor)
+{
+	if (VisualsActor || World == nullptr) return VisualsActor;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	VisualsActor = World->SpawnActor<AActor>(SpawnParams);
+
+	USceneComponent* Root = NewObject<USceneComponent>(VisualsActor, TEXT("Root"));
+	VisualsActor->SetRootComponent(Root);
+	Root->RegisterComponent();
+	return VisualsActor;
+}
+
+void InstancedVisuals::DestroyActor(AActor*& VisualsActor)
+{
+	if (IsValid(VisualsActor))
+	{
+		VisualsActor->Destroy();
+	}
+	VisualsActor = nullptr;
+}
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+class UStaticMesh;
+
+/**
+ * Transient actor holding a subsystem's instanced mesh components. Its root stays at the origin,
+ * so instance transforms are world transforms.
+ */
+namespace InstancedVisuals
+{
+	//Spawns the visuals actor the first time it is needed
+	FRAME_API AActor* GetOrSpawnActor(UWorld* World, AActor*& VisualsActor);
+
+	FRAME_API void DestroyActor(AActor*& VisualsActor);
+
+	//Registers a movable, collision-free instanced mesh component drawing Mesh on the visuals actor
+	template<typename ComponentType = UInstancedStaticMeshComponent>
+	ComponentType* AddMeshComponent(UWorld* World, AActor*& VisualsActor, UStaticMesh* Mesh)
+	{
+		AActor* Owner = GetOrSpawnActor(World, VisualsActor);
+		if (Owner == nullptr) return nullptr;
+
+		ComponentType* MeshComponent = NewObject<ComponentType>(Owner);
+		MeshComponent->SetStaticMesh(Mesh);
+		MeshComponent->SetMobility(EComponentMobility::Movable);
+		MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		MeshComponent->SetupAttachment(Owner->GetRootComponent());
+		MeshComponent->RegisterComponent();
+		Owner->AddInstanceComponent(MeshComponent);
+		return MeshComponent;
+	}
+}
@@ -11,6 +11,12 @@
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 #include "Curves/CurveVector.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "ItemPulseSubsystem.h"
+#include "ItemPulseSettings.h"
+#include "PickupGridSubsystem.h"
+#include "CurveBakerySubsystem.h"
+#include "FrameDataRegistry.h"
 
 
 // Sets default values
@@ -22,6 +28,7 @@ AItem::AItem():
 	ItemState(EItemState::EIS_PickUp),
 	//Item interp 
 	ZCurveTime(0.7f),
+	ItemInterpStartTime(0.f),
 	ItemInterpStartLocation(FVector(0.f)),
 	CameraTargetLocation(FVector(0.f)),
 	bInterping(false),
@@ -31,17 +38,23 @@ AItem::AItem():
 	ItemType(EItemType::EIT_MAX),
 	InterpLocIndex(0),
 	MaterialIndex(0),
+	GroundLootMesh(nullptr),
 	bCanChangeCustomDepth(true),
 	//Dynamic material parameters
 	GlowAmount(150.f),
 	FresnelExponent(3.f),
 	FresnelReflectFraction(4.f),
 	PulseCurveTime(5.f),
+	PulseStartTime(0.f),
+	PulseRelevanceDistance(2500.f),
+	bInPulseRange(false),
 	SlotIndex(0),
 	bCharacterInventoryFull(false)
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+	//Woken by UpdateTickState when there is something to update
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
 	SetRootComponent(ItemMesh);
@@ -56,6 +69,9 @@ AItem::AItem():
 
 	AreaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AreaSphere"));
 	AreaSphere->SetupAttachment(GetRootComponent());
+	//Only its radius is used, characters find pickups through the pickup grid
+	AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	AreaSphere->SetGenerateOverlapEvents(false);
 	
 
 }
@@ -73,56 +89,46 @@ void AItem::BeginPlay()
 
 	//Sets ActiveStars array based on item rarity
 	SetActiveStars();
-	
-	//Set up overlap for area sphere
-	AreaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
-	AreaSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
 
+	BakeCurves();
+	
 	//Set item properties based on ItemState
 	SetItemProperties(ItemState);
 
 	//Set custom depth to disabled
 	InitializeCustomDepth();
 
-	StartPulseTimer();
-}
+	StartPulse();
 
-void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, 
-	AActor* OtherActor, 
-	UPrimitiveComponent* OtherComp, 
-	int32 OtherBodyIndex, 
-	bool bFromSweep, 
-	const FHitResult& SweepResult)
-{
-	if (OtherActor)
+	UItemPulseSubsystem* ItemPulse = GetWorld()->GetSubsystem<UItemPulseSubsystem>();
+	if (ItemPulse)
 	{
-		AFrameCharacter* FrameCharacter = Cast<AFrameCharacter>(OtherActor);
-		if (FrameCharacter)
-		{
-			FrameCharacter->IncrementOverlappedItemCount(1);
-		}
+		ItemPulse->RegisterItem(this);
 	}
+	UpdateTickState();
+	UpdatePickupGrid();
 }
 
-void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent,
-	AActor* OtherActor,
-	UPrimitiveComponent* OtherComp,
-	int32 OtherBodyIndex)
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (OtherActor)
+	UItemPulseSubsystem* ItemPulse = GetWorld()->GetSubsystem<UItemPulseSubsystem>();
+	if (ItemPulse)
 	{
-		AFrameCharacter* FrameCharacter = Cast<AFrameCharacter>(OtherActor);
-		if (FrameCharacter)
-		{
-			FrameCharacter->IncrementOverlappedItemCount(-1);
-			FrameCharacter->UnhighlightInventorySlot();
-		}
+		ItemPulse->UnregisterItem(this);
+	}
+	UPickupGridSubsystem* PickupGrid = GetWorld()->GetSubsystem<UPickupGridSubsystem>();
+	if (PickupGrid)
+	{
+		PickupGrid->RemovePickup(this);
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AItem::SetActiveStars()
 {
 	//0 element is not used
+	ActiveStars.Reset();
 	for (int32 i = 0; i <= 5; i++)
 	{
 		ActiveStars.Add(false);
@@ -171,9 +177,6 @@ void AItem::SetItemProperties(EItemState State)
 		ItemMesh->SetVisibility(true);
 		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		//Area sphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 		//Collision box properties
 		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 		CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
@@ -258,6 +261,11 @@ void AItem::FinishInterp()
 	DisableGlowMaterial();
 	bCanChangeCustomDepth = true;
 	DisableCustomDepth();
+
+	//Back to the looping pulse
+	SetPulseScales(FVector(1.f), false);
+
+	UpdateTickState();
 }
 
 
@@ -265,12 +273,12 @@ void AItem::ItemInterp(float DeltaTime)
 {
 	if (!bInterping) return;
 
-	if (Character && ItemZCurve)
+	if (Character && BakedZCurve)
 	{
-		//Time elapsed since ItemInterpTimer started
-		const float ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpTimer);
+		//Time elapsed since the interp started
+		const float ElapsedTime = GetWorld()->GetTimeSeconds() - ItemInterpStartTime;
 		//Curve value corresponding to elapsed time 
-		const float CurveValue = ItemZCurve->GetFloatValue(ElapsedTime);
+		const float CurveValue = BakedZCurve->Eval(ElapsedTime);
 		//Get initial item location at curve start
 		FVector ItemLocation = ItemInterpStartLocation;
 		const FVector CameraInterpLocation{ GetInterpLocation() };
@@ -298,9 +306,9 @@ void AItem::ItemInterp(float DeltaTime)
 		FRotator ItemRotation{ 0.f, CameraRotation.Yaw + InterpInitialYawOffset, 0.f };
 		SetActorRotation(ItemRotation, ETeleportType::TeleportPhysics);
 
-		if (ItemScaleCurve) //checking if this is a nullptr
+		if (BakedScaleCurve) //checking if this is a nullptr
 		{
-			const float ScaleCurveValue = ItemScaleCurve->GetFloatValue(ElapsedTime);
+			const float ScaleCurveValue = BakedScaleCurve->Eval(ElapsedTime);
 			SetActorScale3D(FVector(ScaleCurveValue, ScaleCurveValue, ScaleCurveValue));
 		}
 	}
@@ -329,27 +337,82 @@ void AItem::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 	//Hadnle item interping when in EquipInterp state
 	ItemInterp(DeltaTime);
-	//Get curve values from PulseCurve and set Dynamic Material parameters
+	//Scale glow by the interp pulse curve
 	UpdatePulse();
 }
 
-void AItem::ResetPulseTimer()
+bool AItem::ShouldTick() const
 {
-	StartPulseTimer();
+	//Pickup pulse runs in the material, only interping needs a tick
+	return bInterping;
 }
 
-void AItem::StartPulseTimer()
+void AItem::UpdateTickState()
 {
-	if (ItemState == EItemState::EIS_PickUp)
+	const bool bShouldTick{ ShouldTick() };
+	if (bShouldTick != IsActorTickEnabled())
+	{
+		SetActorTickEnabled(bShouldTick);
+	}
+}
+
+void AItem::StartPulse()
+{
+	if (ItemState != EItemState::EIS_PickUp) return;
+
+	PulseStartTime = GetWorld()->GetTimeSeconds();
+	UPrimitiveComponent* PulseMesh = GetPulseMesh();
+	if (PulseMesh && GetDefault<UItemPulseSettings>()->UsesPrimitiveData())
 	{
-		GetWorldTimerManager().SetTimer(PulseTimer, this, &AItem::ResetPulseTimer, PulseCurveTime);
+		PulseMesh->SetCustomPrimitiveDataFloat(ItemPulseData::PulseStartTime, PulseStartTime);
 	}
 }
 
+void AItem::UpdatePickupPulse(float WorldTime)
+{
+	if (ItemState != EItemState::EIS_PickUp || !BakedPulseCurve || PulseCurveTime <= 0.f) return;
+
+	const float ElapsedTime{ FMath::Fmod(WorldTime - PulseStartTime, PulseCurveTime) };
+	SetPulseScales(BakedPulseCurve->Eval(ElapsedTime), false);
+}
+
 void AItem::SetItemState(EItemState State)
 {
 	ItemState = State;
 	SetItemProperties(State);
+	UpdateTickState();
+	UpdatePickupGrid();
+}
+
+void AItem::UpdatePickupGrid()
+{
+	UWorld* World = GetWorld();
+	UPickupGridSubsystem* PickupGrid = World ? World->GetSubsystem<UPickupGridSubsystem>() : nullptr;
+	if (PickupGrid == nullptr) return;
+
+	if (ItemState == EItemState::EIS_PickUp)
+	{
+		PickupGrid->UpdatePickup(this);
+	}
+	else
+	{
+		PickupGrid->RemovePickup(this);
+	}
+}
+
+float AItem::GetOverlapRadius() const
+{
+	return AreaSphere->GetScaledSphereRadius();
+}
+
+float AItem::GetAutoPickupRadius() const
+{
+	return 0.f;
+}
+
+float AItem::GetPickupRadius() const
+{
+	return FMath::Max(GetOverlapRadius(), GetAutoPickupRadius());
 }
 
 
@@ -369,9 +432,9 @@ void AItem::StartItemCurve(AFrameCharacter* Char, bool bForcePlaySound)
 	ItemInterpStartLocation = GetActorLocation();
 	bInterping = true;
 	SetItemState(EItemState::EIS_EquipInterping);
-	GetWorldTimerManager().ClearTimer(PulseTimer);
 
 	GetWorldTimerManager().SetTimer(ItemInterpTimer, this, &AItem::FinishInterp, ZCurveTime);
+	ItemInterpStartTime = GetWorld()->GetTimeSeconds();
 
 	//Getting initial yaw of camera and item
 	const float CameraRotationYaw(Character->GetFollowCamera()->GetComponentRotation().Yaw);
@@ -427,100 +490,184 @@ void AItem::InitializeCustomDepth()
 
 void AItem::OnConstruction(const FTransform& Transform)
 {
-	//Data in StatTable loaded here
-	//Path to StatTable
-	FString StatTablePath(TEXT("DataTable'/Game/_Game/Data_Tables/ItemStatDataTable.ItemStatDataTable'"));
-	UDataTable* StatTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *StatTablePath));
-	if (StatTableObject)
+	ApplyRarityStats();
+	InitializePulseMaterial();
+}
+
+void AItem::BakeCurves()
+{
+	BakedZCurve = UCurveBakerySubsystem::GetBakedCurve(this, ItemZCurve);
+	BakedScaleCurve = UCurveBakerySubsystem::GetBakedCurve(this, ItemScaleCurve);
+	BakedPulseCurve = UCurveBakerySubsystem::GetBakedCurve(this, PulseCurve);
+	BakedInterpPulseCurve = UCurveBakerySubsystem::GetBakedCurve(this, InterpPulseCurve);
+}
+
+void AItem::ApplyRarityStats()
+{
+	//Stat row for this rarity, resolved once by the data registry
+	const FItemStatTable* StatRow = UFrameDataRegistry::GetDataTables(this).GetItemStats(ItemRarity);
+	if (StatRow)
 	{
-		FItemStatTable* StatRow = nullptr;
-		switch (ItemRarity)
+		GlowColor = StatRow->GlowColor;
+		LightColor = StatRow->LightColor;
+		DarkColor = StatRow->DarkColor;
+		NumberOfStars = StatRow->NumberOfStars;
+		IconBackground = StatRow->IconBackground;
+		if (GetItemMesh())
 		{
-			case EItemRarity::EIR_Damaged:
-				StatRow = StatTableObject->FindRow<FItemStatTable>(FName("Damaged"), TEXT(""));
-				break;
-			case EItemRarity::EIR_Common:
-				StatRow = StatTableObject->FindRow<FItemStatTable>(FName("Working"), TEXT(""));
-				break;
-			case EItemRarity::EIR_Uncommon:
-				StatRow = StatTableObject->FindRow<FItemStatTable>(FName("Standard"), TEXT(""));
-				break;
-			case EItemRarity::EIR_Rare:
-				StatRow = StatTableObject->FindRow<FItemStatTable>(FName("Super"), TEXT(""));
-				break;
-			case EItemRarity::EIR_Legendary:
-				StatRow = StatTableObject->FindRow<FItemStatTable>(FName("Hyper"), TEXT(""));
-				break;
+			GetItemMesh()->SetCustomDepthStencilValue(StatRow->CustomDepthStencil);
 		}
+	}
+}
+
+void AItem::ResetPooledItem(EItemRarity Rarity, int32 Count, EItemState State)
+{
+	ItemRarity = Rarity;
+	ItemCount = Count;
+	ApplyRarityStats();
+	SetActiveStars();
+	InitializePulseMaterial();
+
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	Character = nullptr;
+	bInterping = false;
+	InterpLocIndex = 0;
+	SlotIndex = 0;
+	bCharacterInventoryFull = false;
+	SetActorScale3D(FVector(1.f));
+
+	bCanChangeCustomDepth = true;
+	DisableCustomDepth();
+	SetItemState(State);
+	StartPulse();
+}
 
-		if (StatRow)
+void AItem::InitializePulseMaterial()
+{
+	UPrimitiveComponent* PulseMesh = GetPulseMesh();
+	if (GetDefault<UItemPulseSettings>()->UsesPrimitiveData())
+	{
+		DynamicMaterialInstance = nullptr;
+		if (WritePulseData(PulseMesh, GlowColor))
 		{
-			GlowColor = StatRow->GlowColor;
-			LightColor = StatRow->LightColor;
-			DarkColor = StatRow->DarkColor;
-			NumberOfStars = StatRow->NumberOfStars;
-			IconBackground = StatRow->IconBackground;
-			if (GetItemMesh())
-			{
-				GetItemMesh()->SetCustomDepthStencilValue(StatRow->CustomDepthStencil);
-			}
+			EnableGlowMaterial();
 		}
+		return;
 	}
-	if (MaterialInstance)
+
+	if (MaterialInstance && PulseMesh)
 	{
-		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
-		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
-		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
+		//Reuse the instance when only the colour changed, pooled items come through here on every reset
+		if (DynamicMaterialInstance && DynamicMaterialInstance->Parent == MaterialInstance)
+		{
+			DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
+			PulseMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
+		}
+		else
+		{
+			DynamicMaterialInstance = CreatePulseMaterial(PulseMesh, GlowColor);
+		}
 		EnableGlowMaterial();
 	}
 }
 
+UMaterialInstanceDynamic* AItem::CreatePulseMaterial(UPrimitiveComponent* PulseMesh, const FLinearColor& PulseGlowColor) const
+{
+	UMaterialInstanceDynamic* PulseMaterial = UMaterialInstanceDynamic::Create(MaterialInstance, PulseMesh);
+	PulseMaterial->SetVectorParameterValue(TEXT("FresnelColor"), PulseGlowColor);
+	PulseMaterial->SetScalarParameterValue(TEXT("GlowAmount"), GlowAmount);
+	PulseMaterial->SetScalarParameterValue(TEXT("FresnelExponent"), FresnelExponent);
+	PulseMaterial->SetScalarParameterValue(TEXT("FresnelReflectFraction"), FresnelReflectFraction);
+	PulseMaterial->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0.f);
+	PulseMesh->SetMaterial(MaterialIndex, PulseMaterial);
+	return PulseMaterial;
+}
+
+bool AItem::WritePulseData(UPrimitiveComponent* PulseMesh, const FLinearColor& PulseGlowColor) const
+{
+	if (MaterialInstance == nullptr || PulseMesh == nullptr) return false;
+
+	if (!GetDefault<UItemPulseSettings>()->UsesPrimitiveData())
+	{
+		//Material still takes per-item parameters, so this mesh gets a steady glow of its own
+		CreatePulseMaterial(PulseMesh, PulseGlowColor);
+		return true;
+	}
+
+	//Same material for every item, so identical pickups can be drawn together
+	PulseMesh->SetMaterial(MaterialIndex, MaterialInstance);
+	PulseMesh->SetCustomPrimitiveDataVector3(ItemPulseData::GlowColor, FVector(PulseGlowColor.R, PulseGlowColor.G, PulseGlowColor.B));
+	PulseMesh->SetCustomPrimitiveDataVector3(ItemPulseData::PulseScales, FVector(GlowAmount, FresnelExponent, FresnelReflectFraction));
+	PulseMesh->SetCustomPrimitiveDataFloat(ItemPulseData::InterpPulse, 0.f);
+	PulseMesh->SetCustomPrimitiveDataFloat(ItemPulseData::PulsePeriod, PulseCurveTime);
+	return true;
+}
+
+UStaticMesh* AItem::GetGroundLootMesh() const
+{
+	return GroundLootMesh;
+}
+
+UPrimitiveComponent* AItem::GetPulseMesh() const
+{
+	return ItemMesh;
+}
+
 void AItem::EnableGlowMaterial()
 {
+	UPrimitiveComponent* PulseMesh = GetPulseMesh();
 	if (DynamicMaterialInstance)
 	{
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0);
+		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0.f);
+	}
+	else if (PulseMesh)
+	{
+		PulseMesh->SetCustomPrimitiveDataFloat(ItemPulseData::GlowBlendAlpha, 0.f);
 	}
 }
 
 void AItem::DisableGlowMaterial()
 {
+	UPrimitiveComponent* PulseMesh = GetPulseMesh();
 	if (DynamicMaterialInstance)
 	{
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 1);
+		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 1.f);
+	}
+	else if (PulseMesh)
+	{
+		PulseMesh->SetCustomPrimitiveDataFloat(ItemPulseData::GlowBlendAlpha, 1.f);
 	}
 }
 
-void AItem::UpdatePulse()
+void AItem::SetPulseScales(const FVector& Scales, bool bInterpPulse)
 {
-	float ElapsedTime{};
-	FVector CurveValue{};
-	switch (ItemState)
+	const FVector PulseValues{ Scales.X * GlowAmount, Scales.Y * FresnelExponent, Scales.Z * FresnelReflectFraction };
+	if (DynamicMaterialInstance)
 	{
-		case EItemState::EIS_PickUp:
-			if (PulseCurve)
-			{
-				ElapsedTime = GetWorldTimerManager().GetTimerElapsed(PulseTimer);
-				CurveValue = PulseCurve->GetVectorValue(ElapsedTime);
-			}
-			break;
-		case EItemState::EIS_EquipInterping:
-			if (InterpPulseCurve)
-			{
-				ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpTimer);
-				CurveValue = InterpPulseCurve->GetVectorValue(ElapsedTime);
-			}
-			break;
+		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), PulseValues.X);
+		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), PulseValues.Y);
+		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelReflectFraction"), PulseValues.Z);
+		return;
 	}
 
-	if (DynamicMaterialInstance)
+	UPrimitiveComponent* PulseMesh = GetPulseMesh();
+	if (PulseMesh)
 	{
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), CurveValue.X * GlowAmount);
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), CurveValue.Y * FresnelExponent);
-		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelReflectFraction"), CurveValue.Z * FresnelReflectFraction);
+		//While interping the material uses these as final values instead of looping the pulse
+		PulseMesh->SetCustomPrimitiveDataFloat(ItemPulseData::InterpPulse, bInterpPulse ? 1.f : 0.f);
+		PulseMesh->SetCustomPrimitiveDataVector3(ItemPulseData::PulseScales, PulseValues);
 	}
 }
 
+void AItem::UpdatePulse()
+{
+	if (ItemState != EItemState::EIS_EquipInterping || !BakedInterpPulseCurve) return;
+
+	const float ElapsedTime = GetWorld()->GetTimeSeconds() - ItemInterpStartTime;
+	//Override the looping pulse with this item's own values
+	SetPulseScales(BakedInterpPulseCurve->Eval(ElapsedTime), true);
+}
+
 void AItem::PlayEquipSound(bool bForcePlaySound)
 {	
 	if (Character)
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Engine/DataTable.h"
+#include "BakedCurve.h"
 #include "Item.generated.h"
 
 UENUM(BlueprintType)
@@ -77,21 +78,7 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-	//Called when overlapping area sphere
-	UFUNCTION()
-	void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, 
-	AActor* OtherActor, 
-	UPrimitiveComponent* OtherComp, 
-	int32 OtherBodyIndex, 
-	bool bFromSweep, 
-	const FHitResult& SweepResult);
-
-	//Called when overlap ends
-	UFUNCTION()
-	void OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent,
-	AActor* OtherActor,
-	UPrimitiveComponent* OtherComp,
-	int32 OtherBodyIndex);
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	//Sets number of stars based on array of bools and rarity
 	void SetActiveStars();
@@ -114,11 +101,39 @@ protected:
 
 	virtual void OnConstruction(const FTransform& Transform) override;
 
+	//Reads colours, stars and stencil for ItemRarity from the item stat table
+	void ApplyRarityStats();
+
+	//Looks up baked tables for the curves evaluated every frame
+	virtual void BakeCurves();
+
 	void EnableGlowMaterial();
 
+	//Applies the glow material, shared when pulse values go in custom primitive data, else a dynamic instance
+	void InitializePulseMaterial();
+
+	//Creates a dynamic glow material on PulseMesh for materials that still take per-item parameters
+	class UMaterialInstanceDynamic* CreatePulseMaterial(UPrimitiveComponent* PulseMesh, const FLinearColor& PulseGlowColor) const;
+
+	//Writes GlowAmount, FresnelExponent and FresnelReflectFraction scales to the glow material
+	void SetPulseScales(const FVector& Scales, bool bInterpPulse);
+
+	//Mesh carrying the glow material
+	virtual UPrimitiveComponent* GetPulseMesh() const;
+
+	//Drives the interp pulse while the item flies to the camera
 	void UpdatePulse();
-	void ResetPulseTimer();
-	void StartPulseTimer();
+	//Restarts the looping pickup pulse from now
+	void StartPulse();
+
+	//True while the item has per-frame work
+	virtual bool ShouldTick() const;
+
+	//Turns ticking on or off to match ShouldTick, called whenever its inputs change
+	void UpdateTickState();
+
+	//Adds the item to the pickup grid while it is lying in the world, removes it otherwise
+	void UpdatePickupGrid();
 	
 	
 
@@ -185,6 +200,9 @@ private:
 	//Plays when we item starts interping
 	FTimerHandle ItemInterpTimer;
 
+	//World time the interp started, curves are evaluated from here
+	float ItemInterpStartTime;
+
 	//Duration of curve and timer
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float ZCurveTime;
@@ -224,29 +242,41 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	int32 MaterialIndex;
 
-	//Dynamic instance we can change at runtime
+	//Glow material, shared by every item using it when per-item values go in custom primitive data
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	UMaterialInstance* MaterialInstance;
+
+	//Dynamic instance we can change at runtime, unused when the pulse lives in custom primitive data
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	UMaterialInstanceDynamic* DynamicMaterialInstance;
 
-	//Material instance used with dynamic material instance
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	UMaterialInstance* MaterialInstance;
+	//Static mesh drawn for this item as instanced ground loot, none keeps it a full actor
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	class UStaticMesh* GroundLootMesh;
 
 	bool bCanChangeCustomDepth;
 
-	//Curve to drive dynamic material parameters
+	//Curve to drive dynamic material parameters while lying in the world
 	UPROPERTY(EditDefaultsOnly, BlueprintReadonly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class UCurveVector* PulseCurve;
 
+	//Curve scaling the pulse values while interping to the camera
 	UPROPERTY(EditDefaultsOnly, BlueprintReadonly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	UCurveVector* InterpPulseCurve;
+	class UCurveVector* InterpPulseCurve;
 
-	FTimerHandle PulseTimer;
-	
-	//Time for the PulseTimer
+	//Baked tables of ItemZCurve, ItemScaleCurve, PulseCurve and InterpPulseCurve
+	TSharedPtr<const FBakedFloatCurve> BakedZCurve;
+	TSharedPtr<const FBakedFloatCurve> BakedScaleCurve;
+	TSharedPtr<const FBakedVectorCurve> BakedPulseCurve;
+	TSharedPtr<const FBakedVectorCurve> BakedInterpPulseCurve;
+
+	//Length of one pickup pulse, looped from PulseStartTime
 	UPROPERTY(EditDefaultsOnly, BlueprintReadonly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float PulseCurveTime;
 
+	//World time the current pickup pulse started
+	float PulseStartTime;
+
 	UPROPERTY(VisibleAnywhere, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float GlowAmount;
 	
@@ -256,6 +286,13 @@ private:
 	UPROPERTY(VisibleAnywhere, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float FresnelReflectFraction;
 
+	//Pickups further than this from the camera stop sampling their pulse
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	float PulseRelevanceDistance;
+
+	//Set by the item pulse subsystem when near the camera and on screen
+	bool bInPulseRange;
+
 	//Icon for item in inventory
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* IconItem;
@@ -300,6 +337,13 @@ private:
 public:
 	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget; }
 	FORCEINLINE USphereComponent* GetAreaSphere() const { return AreaSphere; }
+
+	//Radius of the area sphere, characters inside it can see and pick up the item
+	float GetOverlapRadius() const;
+	//Characters inside this radius pick the item up straight away, 0 if they never do
+	virtual float GetAutoPickupRadius() const;
+	//Largest radius a character can interact with the item from
+	float GetPickupRadius() const;
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return CollisionBox; }
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 
@@ -311,6 +355,9 @@ public:
 	FORCEINLINE USoundCue* GetEquipSound() const { return EquipSound; }
 	FORCEINLINE void SetEquipSound(USoundCue* Sound) { EquipSound = Sound; } 
 	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
+	FORCEINLINE void SetItemCount(int32 Count) { ItemCount = Count; }
+	FORCEINLINE EItemRarity GetItemRarity() const { return ItemRarity; }
+	FORCEINLINE void SetItemRarity(EItemRarity Rarity) { ItemRarity = Rarity; }
 	FORCEINLINE int32 GetSlotIndex() const { return SlotIndex; }
 	FORCEINLINE void SetSlotIndex(int32 Index) { SlotIndex = Index; }
 	FORCEINLINE void SetCharacter(AFrameCharacter* Char) { Character = Char; }
@@ -318,18 +365,36 @@ public:
 	FORCEINLINE void SetItemName(FString Name) { ItemName = Name; }
 	//Set ItemIcon for inventory
 	FORCEINLINE void SetIconItem(UTexture2D* Icon) { IconItem = Icon; }
+	FORCEINLINE UTexture2D* GetIconItem() const { return IconItem; }
+	FORCEINLINE UTexture2D* GetIconBackground() const { return IconBackground; }
 	//Set Ammo Icon for pickup widget
 	FORCEINLINE void SetAmmoIcon(UTexture2D* Icon) { AmmoItem = Icon; }
+	FORCEINLINE UTexture2D* GetAmmoIcon() const { return AmmoItem; }
 	FORCEINLINE UMaterialInstance* GetMaterialInstance() const { return MaterialInstance; }
 	FORCEINLINE void SetMaterialInstance(UMaterialInstance* Instance) { MaterialInstance = Instance; }
 	FORCEINLINE UMaterialInstanceDynamic* GetDynamicMaterialInstance() const { return DynamicMaterialInstance; }
 	FORCEINLINE void SetDynamicMaterialInstance(UMaterialInstanceDynamic* Instance) { DynamicMaterialInstance = Instance; }
+	FORCEINLINE float GetPulseRelevanceDistance() const { return PulseRelevanceDistance; }
+	FORCEINLINE bool IsInPulseRange() const { return bInPulseRange; }
+	FORCEINLINE void SetInPulseRange(bool bInRange) { bInPulseRange = bInRange; }
 	FORCEINLINE FLinearColor GetGlowColor() const { return GlowColor; }
 	FORCEINLINE int32 GetMaterialIndex() const { return MaterialIndex; }
 	FORCEINLINE void SetMaterialIndex(int32 Index) { MaterialIndex = Index; }
 
 	//Called from AFrameCharacter class
 	void StartItemCurve(AFrameCharacter* Char, bool bForcePlaySound = false);
+
+	//Applies the glow material and pulse values with the given colour to any mesh, including ground loot instances
+	bool WritePulseData(UPrimitiveComponent* PulseMesh, const FLinearColor& PulseGlowColor) const;
+
+	//Samples PulseCurve for the looping pickup glow, called by the item pulse subsystem for items
+	//in pulse range while the glow material takes per-item parameters
+	void UpdatePickupPulse(float WorldTime);
+
+	virtual UStaticMesh* GetGroundLootMesh() const;
+
+	//Called by the pickup pool to reactivate the item, clears what the last pickup left behind
+	virtual void ResetPooledItem(EItemRarity Rarity, int32 Count, EItemState State);
 	
 	virtual void EnableCustomDepth();
 	virtual void DisableCustomDepth();
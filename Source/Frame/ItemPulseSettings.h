@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "ItemPulseSettings.generated.h"
+
+class UMaterialParameterCollection;
+
+/**
+ * Chooses how item glow pulses are drawn, editable under Project Settings > Game > Item Pulse
+ * and saved to DefaultGame.ini.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Item Pulse"))
+class FRAME_API UItemPulseSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	virtual FName GetCategoryName() const override { return FName("Game"); }
+
+	//True once glow materials read their per-item values from custom primitive data
+	FORCEINLINE bool UsesPrimitiveData() const { return !PulseCollection.IsNull(); }
+
+	//Collection with a PulseTime scalar the glow material loops its pulse from, with per-item values
+	//in custom primitive data. Leave empty while glow materials still take per-item parameters
+	UPROPERTY(Config, EditAnywhere, Category = Pulse)
+	TSoftObjectPtr<UMaterialParameterCollection> PulseCollection;
+};
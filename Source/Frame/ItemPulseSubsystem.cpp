@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemPulseSubsystem.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "Kismet/GameplayStatics.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Item.h"
+#include "ItemPulseSettings.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Item Relevance"), STAT_UpdateItemRelevance, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Items"), STAT_ActiveItems, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Items"), STAT_DormantItems, STATGROUP_Frame);
+
+void UItemPulseSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const UItemPulseSettings* Settings = GetDefault<UItemPulseSettings>();
+	if (!Settings->UsesPrimitiveData()) return;
+
+	PulseCollection = Settings->PulseCollection.LoadSynchronous();
+	if (PulseCollection)
+	{
+		PulseCollectionInstance = InWorld.GetParameterCollectionInstance(PulseCollection);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Item pulse collection %s failed to load, pickups will not pulse"), *Settings->PulseCollection.ToString());
+	}
+}
+
+void UItemPulseSubsystem::RegisterItem(AItem* Item)
+{
+	if (Item)
+	{
+		Items.AddUnique(Item);
+	}
+}
+
+void UItemPulseSubsystem::UnregisterItem(AItem* Item)
+{
+	Items.RemoveSingleSwap(Item, false);
+	PulsingItems.RemoveSingleSwap(Item, false);
+}
+
+void UItemPulseSubsystem::Tick(float DeltaTime)
+{
+	const float WorldTime{ GetWorld()->GetTimeSeconds() };
+	if (PulseCollectionInstance)
+	{
+		//One parameter write per frame pulses every item in the world
+		PulseCollectionInstance->SetScalarParameterValue(FName("PulseTime"), WorldTime);
+	}
+	else if (!GetDefault<UItemPulseSettings>()->UsesPrimitiveData())
+	{
+		for (AItem* Item : PulsingItems)
+		{
+			if (IsValid(Item))
+			{
+				Item->UpdatePickupPulse(WorldTime);
+			}
+		}
+	}
+
+	TimeSinceRelevanceCheck += DeltaTime;
+	if (TimeSinceRelevanceCheck >= RelevanceCheckInterval)
+	{
+		TimeSinceRelevanceCheck = 0.f;
+		UpdateRelevance();
+	}
+}
+
+void UItemPulseSubsystem::UpdateRelevance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UpdateItemRelevance);
+
+	APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0);
+	const bool bHasViewer{ CameraManager != nullptr };
+	const FVector ViewLocation{ bHasViewer ? CameraManager->GetCameraLocation() : FVector(0.f) };
+
+	//With the pulse in the material, pickups in range cost nothing on the game thread
+	const bool bSamplesPulse{ !GetDefault<UItemPulseSettings>()->UsesPrimitiveData() };
+
+	PulsingItems.Reset();
+	NumActiveItems = 0;
+	for (AItem* Item : Items)
+	{
+		if (!IsValid(Item)) continue;
+
+		//Near the player and drawn recently - pulse is worth updating
+		const float RelevanceDistance{ Item->GetPulseRelevanceDistance() };
+		const bool bInPulseRange{ bHasViewer
+			&& Item->GetItemState() == EItemState::EIS_PickUp
+			&& FVector::DistSquared(ViewLocation, Item->GetActorLocation()) <= RelevanceDistance * RelevanceDistance
+			&& Item->WasRecentlyRendered(RelevanceCheckInterval) };
+		Item->SetInPulseRange(bInPulseRange);
+
+		const bool bPulsing{ bInPulseRange && bSamplesPulse };
+		if (bPulsing)
+		{
+			PulsingItems.Add(Item);
+		}
+		if (bPulsing || Item->IsActorTickEnabled())
+		{
+			NumActiveItems++;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ActiveItems, NumActiveItems);
+	SET_DWORD_STAT(STAT_DormantItems, Items.Num() - NumActiveItems);
+}
+
+TStatId UItemPulseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemPulseSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemPulseSubsystem.generated.h"
+
+class AItem;
+class UMaterialParameterCollection;
+class UMaterialParameterCollectionInstance;
+
+//Custom primitive data slots read by the item glow material
+namespace ItemPulseData
+{
+	//World time the item's pulse started, material loops from here
+	constexpr int32 PulseStartTime{ 0 };
+	//RGB rarity glow colour from the item stat table
+	constexpr int32 GlowColor{ 1 };
+	//GlowAmount, FresnelExponent, FresnelReflectFraction scales
+	constexpr int32 PulseScales{ 4 };
+	//0 shows the glow, 1 hides it
+	constexpr int32 GlowBlendAlpha{ 7 };
+	//1 while interping - the material uses PulseScales as final values instead of sampling the pulse
+	constexpr int32 InterpPulse{ 8 };
+	//Length of one pulse in seconds
+	constexpr int32 PulsePeriod{ 9 };
+}
+
+/**
+ * Drives the glow pulse of every item from one clock, so items need no tick or timer of their own.
+ * With a pulse collection set in UItemPulseSettings the world time is written to it once a frame and
+ * items only hold per-item values in custom primitive data, so identical pickups share a material.
+ * Without one, each pickup's dynamic glow material is sampled from its pulse curve here instead,
+ * only for pickups a relevance pass five times a second finds near the camera and on screen.
+ * Also counts items that are ticking or pulsing against ones that are asleep.
+ */
+UCLASS()
+class FRAME_API UItemPulseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Called from AItem BeginPlay and EndPlay
+	void RegisterItem(AItem* Item);
+	void UnregisterItem(AItem* Item);
+
+	FORCEINLINE int32 GetNumActiveItems() const { return NumActiveItems; }
+	FORCEINLINE int32 GetNumDormantItems() const { return Items.Num() - NumActiveItems; }
+
+private:
+
+	//Marks items near the camera and recently rendered as in pulse range, and counts active items
+	void UpdateRelevance();
+
+	UPROPERTY()
+	TArray<AItem*> Items;
+
+	//Pickups in pulse range as of the last relevance pass, sampled every frame
+	UPROPERTY()
+	TArray<AItem*> PulsingItems;
+
+	UPROPERTY()
+	UMaterialParameterCollection* PulseCollection = nullptr;
+
+	UPROPERTY()
+	UMaterialParameterCollectionInstance* PulseCollectionInstance = nullptr;
+
+	//Seconds between relevance passes
+	static constexpr float RelevanceCheckInterval{ 0.2f };
+
+	float TimeSinceRelevanceCheck = 0.f;
+
+	int32 NumActiveItems = 0;
+};
@@ -4,9 +4,22 @@
 #include "KillAllEnemiesGameMode.h"
 #include "EngineUtils.h"
 #include "GameFramework/Controller.h"
-#include "EnemyAIController.h"
+#include "EnemyRegistrySubsystem.h"
+#include "HordeSubsystem.h"
+#include "EnemyPoolSubsystem.h"
 
 
+void AKillAllEnemiesGameMode::BeginPlay()
+{
+    Super::BeginPlay();
+
+    UHordeSubsystem* Horde = GetWorld()->GetSubsystem<UHordeSubsystem>();
+    if (Horde)
+    {
+        Horde->OnHordeEnemyKilled.AddUObject(this, &AKillAllEnemiesGameMode::OnHordeEnemyKilled);
+    }
+}
+
 void AKillAllEnemiesGameMode::PawnKilled(APawn* PawnKilled)
 {
     Super::PawnKilled(PawnKilled);
@@ -15,17 +28,44 @@ void AKillAllEnemiesGameMode::PawnKilled(APawn* PawnKilled)
     if (PlayerController != nullptr)
     {
        EndGame(false);
+       return;
+    }
+
+    if (AreAllEnemiesDead())
+    {
+        EndGame(true);
+    }
+}
+
+void AKillAllEnemiesGameMode::OnHordeEnemyKilled(AActor* Owner, AEnemy* Enemy)
+{
+    // Promoted enemies die as actors and are counted in PawnKilled
+    if (Enemy == nullptr && AreAllEnemiesDead())
+    {
+        EndGame(true);
+    }
+}
+
+bool AKillAllEnemiesGameMode::AreAllEnemiesDead() const
+{
+    const UWorld* World = GetWorld();
+
+    const UEnemyRegistrySubsystem* Registry = World->GetSubsystem<UEnemyRegistrySubsystem>();
+    // Waves a spawner has still to start are alive too, or the gap between waves would end the game
+    if (Registry && (Registry->GetNumAlive() > 0 || Registry->HasPendingSpawns()))
+    {
+        return false;
     }
 
-    for (AEnemyAIController* Controller : TActorRange<AEnemyAIController>(GetWorld()))
+    // Horde entities and enemies still waiting to spawn are alive without an actor
+    const UHordeSubsystem* Horde = World->GetSubsystem<UHordeSubsystem>();
+    if (Horde && Horde->GetNumEntities() > 0)
     {
-        if (!Controller->IsDead())
-        {
-            return;
-        }
+        return false;
     }
 
-    EndGame(true);
+    const UEnemyPoolSubsystem* Pool = World->GetSubsystem<UEnemyPoolSubsystem>();
+    return Pool == nullptr || Pool->GetNumQueuedActivations() == 0;
 }
 
 void AKillAllEnemiesGameMode::EndGame(bool bIsPlayerWinner)
@@ -18,7 +18,17 @@ public:
 
 	virtual void PawnKilled(APawn* PawnKilled) override;
 
+protected:
+
+	virtual void BeginPlay() override;
+
 private:
 
 	void EndGame(bool bIsPlayerWinner);
+
+	// Entities killed as data never reach PawnKilled
+	void OnHordeEnemyKilled(AActor* Owner, class AEnemy* Enemy);
+
+	// Counter checks against the enemy registry, horde and spawn queue, no actor iteration
+	bool AreAllEnemiesDead() const;
 };
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MeleeTraceComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "MeleeTraceSubsystem.h"
+
+UMeleeTraceComponent::UMeleeTraceComponent() :
+	TraceMesh(nullptr)
+{
+	//Swept by the subsystem, never ticks on its own
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UMeleeTraceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	EndAllSwings();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UMeleeTraceComponent::BeginSwing(FName SocketName, const FVector& BladeStart, const FVector& BladeEnd, float Radius)
+{
+	USceneComponent* Mesh = GetTraceMesh();
+	if (Mesh == nullptr) return;
+
+	FMeleeSwing* Swing = ActiveSwings.FindByPredicate([SocketName](const FMeleeSwing& Active) { return Active.SocketName == SocketName; });
+	if (Swing == nullptr)
+	{
+		Swing = &ActiveSwings.AddDefaulted_GetRef();
+		Swing->SocketName = SocketName;
+	}
+	Swing->BladeStart = BladeStart;
+	Swing->BladeEnd = BladeEnd;
+	Swing->Radius = Radius;
+	float WorldRadius;
+	GetBladeInWorld(Mesh, *Swing, Swing->PreviousStart, Swing->PreviousEnd, WorldRadius);
+	Swing->HitActors.Reset();
+
+	UMeleeTraceSubsystem* MeleeTraces = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTraces)
+	{
+		MeleeTraces->AddSwingingComponent(this);
+	}
+}
+
+void UMeleeTraceComponent::EndSwing(FName SocketName)
+{
+	ActiveSwings.RemoveAllSwap([SocketName](const FMeleeSwing& Active) { return Active.SocketName == SocketName; });
+}
+
+void UMeleeTraceComponent::EndAllSwings()
+{
+	ActiveSwings.Reset();
+}
+
+void UMeleeTraceComponent::SetTraceMesh(USceneComponent* Mesh)
+{
+	TraceMesh = Mesh;
+}
+
+USceneComponent* UMeleeTraceComponent::GetTraceMesh() const
+{
+	if (TraceMesh) return TraceMesh;
+
+	const AActor* Owner = GetOwner();
+	return Owner ? Owner->FindComponentByClass<USkeletalMeshComponent>() : nullptr;
+}
+
+void UMeleeTraceComponent::GetBladeInWorld(const USceneComponent* Mesh, const FMeleeSwing& Swing, FVector& OutStart, FVector& OutEnd, float& OutRadius)
+{
+	const FTransform SocketTransform{ Mesh->GetSocketTransform(Swing.SocketName) };
+	OutStart = SocketTransform.TransformPosition(Swing.BladeStart);
+	OutEnd = SocketTransform.TransformPosition(Swing.BladeEnd);
+	OutRadius = Swing.Radius * SocketTransform.GetMaximumAxisScale();
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MeleeTraceComponent.generated.h"
+
+//Victim, point on the weapon path closest to them, socket of the swing that hit
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnMeleeHit, AActor*, const FVector&, FName);
+
+//Hit window of one weapon, a blade segment in the space of the socket it is held by
+struct FMeleeSwing
+{
+	FName SocketName;
+	FVector BladeStart;
+	FVector BladeEnd;
+
+	//Scaled with the mesh like the blade
+	float Radius = 0.f;
+
+	//Blade ends in world space when the last sweep ended
+	FVector PreviousStart;
+	FVector PreviousEnd;
+
+	//Everything this swing already hit, each victim is reported once per window
+	TArray<TWeakObjectPtr<AActor>> HitActors;
+};
+
+/**
+ * Sweeps weapon blades held by sockets of the owner's mesh between frames while an attack window is open.
+ * Sweeps are run for every active component together by UMeleeTraceSubsystem and each victim
+ * is reported through OnMeleeHit once per swing.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class FRAME_API UMeleeTraceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMeleeTraceComponent();
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//Opens a hit window for a blade held by a socket, restarting it with an empty hit set if already open
+	void BeginSwing(FName SocketName, const FVector& BladeStart, const FVector& BladeEnd, float Radius);
+	void EndSwing(FName SocketName);
+	void EndAllSwings();
+
+	FORCEINLINE bool IsSwinging() const { return ActiveSwings.Num() > 0; }
+
+	//Mesh the sockets are read from, the owner's first skeletal mesh unless set
+	void SetTraceMesh(USceneComponent* Mesh);
+	USceneComponent* GetTraceMesh() const;
+
+	//Blade ends and radius in world space for the mesh's current pose
+	static void GetBladeInWorld(const USceneComponent* Mesh, const FMeleeSwing& Swing, FVector& OutStart, FVector& OutEnd, float& OutRadius);
+
+	FOnMeleeHit OnMeleeHit;
+
+private:
+	friend class UMeleeTraceSubsystem;
+
+	TArray<FMeleeSwing> ActiveSwings;
+
+	UPROPERTY()
+	USceneComponent* TraceMesh;
+};
@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MeleeTraceSubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+#include "MeleeTraceComponent.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee Traces"), STAT_MeleeTraces, STATGROUP_Frame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Melee Swings"), STAT_MeleeSwings, STATGROUP_Frame);
+
+namespace
+{
+	//Part of one swing's path this frame
+	struct FSweptSegment
+	{
+		int32 SwingIndex;
+		FVector Start;
+		FVector End;
+		float Radius;
+	};
+
+	//Victim found this frame, reported once every sweep is done
+	struct FMeleeHit
+	{
+		TWeakObjectPtr<UMeleeTraceComponent> Component;
+		TWeakObjectPtr<AActor> Victim;
+		FVector ImpactPoint;
+		FName SocketName;
+	};
+}
+
+void UMeleeTraceSubsystem::Deinitialize()
+{
+	SwingingComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMeleeTraceSubsystem::AddSwingingComponent(UMeleeTraceComponent* Component)
+{
+	SwingingComponents.AddUnique(Component);
+}
+
+void UMeleeTraceSubsystem::Tick(float DeltaTime)
+{
+	if (SwingingComponents.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_MeleeTraces);
+
+	TArray<FMeleeHit> Hits;
+	TArray<FSweptSegment, TInlineAllocator<8>> Segments;
+	TArray<FOverlapResult> Overlaps;
+	int32 NumSwings{ 0 };
+	for (int32 i = SwingingComponents.Num() - 1; i >= 0; i--)
+	{
+		UMeleeTraceComponent* Component = SwingingComponents[i].Get();
+		const USceneComponent* Mesh = Component ? Component->GetTraceMesh() : nullptr;
+		if (Mesh == nullptr || !Component->IsSwinging())
+		{
+			SwingingComponents.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		//Gather this component's swing paths, all within one attacker's reach
+		Segments.Reset();
+		FBox SweptBounds(ForceInit);
+		for (int32 SwingIndex = 0; SwingIndex < Component->ActiveSwings.Num(); SwingIndex++)
+		{
+			FMeleeSwing& Swing = Component->ActiveSwings[SwingIndex];
+			FVector Start;
+			FVector End;
+			float Radius;
+			UMeleeTraceComponent::GetBladeInWorld(Mesh, Swing, Start, End, Radius);
+
+			//The blade where it is now, plus the paths of its ends and middle since the last sweep
+			Segments.Add({ SwingIndex, Start, End, Radius });
+			Segments.Add({ SwingIndex, Swing.PreviousStart, Start, Radius });
+			Segments.Add({ SwingIndex, Swing.PreviousEnd, End, Radius });
+			Segments.Add({ SwingIndex, (Swing.PreviousStart + Swing.PreviousEnd) * 0.5f, (Start + End) * 0.5f, Radius });
+			SweptBounds += FBox::BuildAABB(Swing.PreviousStart, FVector(Radius));
+			SweptBounds += FBox::BuildAABB(Swing.PreviousEnd, FVector(Radius));
+			SweptBounds += FBox::BuildAABB(Start, FVector(Radius));
+			SweptBounds += FBox::BuildAABB(End, FVector(Radius));
+			Swing.PreviousStart = Start;
+			Swing.PreviousEnd = End;
+		}
+		NumSwings += Component->ActiveSwings.Num();
+		if (Segments.Num() == 0) continue;
+
+		//One small physics query per attacker, sized by its own swings rather than by every swing in the world
+		Overlaps.Reset();
+		GetWorld()->OverlapMultiByObjectType(Overlaps, SweptBounds.GetCenter(), FQuat::Identity,
+			FCollisionObjectQueryParams(ECollisionChannel::ECC_Pawn), FCollisionShape::MakeBox(SweptBounds.GetExtent()),
+			FCollisionQueryParams(SCENE_QUERY_STAT(MeleeTraces), false, Component->GetOwner()));
+
+		TArray<const UCapsuleComponent*, TInlineAllocator<8>> Capsules;
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			const ACharacter* Character = Cast<ACharacter>(Overlap.GetActor());
+			if (Character && Overlap.GetComponent() == Character->GetCapsuleComponent())
+			{
+				Capsules.AddUnique(Character->GetCapsuleComponent());
+			}
+		}
+		if (Capsules.Num() == 0) continue;
+
+		for (const FSweptSegment& Segment : Segments)
+		{
+			FMeleeSwing& Swing = Component->ActiveSwings[Segment.SwingIndex];
+
+			for (const UCapsuleComponent* Capsule : Capsules)
+			{
+				AActor* Victim = Capsule->GetOwner();
+				if (Swing.HitActors.Contains(Victim)) continue;
+
+				//Capsule's inner segment, the swept blade touches it within both radii
+				const float CapsuleRadius{ Capsule->GetScaledCapsuleRadius() };
+				const FVector CapsuleAxis{ Capsule->GetUpVector() * (Capsule->GetScaledCapsuleHalfHeight() - CapsuleRadius) };
+				const FVector CapsuleCenter{ Capsule->GetComponentLocation() };
+
+				FVector PointOnSwing;
+				FVector PointOnCapsule;
+				FMath::SegmentDistToSegmentSafe(Segment.Start, Segment.End, CapsuleCenter - CapsuleAxis, CapsuleCenter + CapsuleAxis, PointOnSwing, PointOnCapsule);
+				if (FVector::DistSquared(PointOnSwing, PointOnCapsule) > FMath::Square(Segment.Radius + CapsuleRadius)) continue;
+
+				Swing.HitActors.Add(Victim);
+				Hits.Add({ Component, Victim, PointOnSwing, Swing.SocketName });
+			}
+		}
+	}
+	SET_DWORD_STAT(STAT_MeleeSwings, NumSwings);
+
+	//Handlers may end swings or kill actors, so nothing above is touched after this
+	for (const FMeleeHit& Hit : Hits)
+	{
+		UMeleeTraceComponent* Component = Hit.Component.Get();
+		AActor* Victim = Hit.Victim.Get();
+		if (Component && Victim)
+		{
+			Component->OnMeleeHit.Broadcast(Victim, Hit.ImpactPoint, Hit.SocketName);
+		}
+	}
+}
+
+TStatId UMeleeTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeleeTraceSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MeleeTraceSubsystem.generated.h"
+
+class UMeleeTraceComponent;
+
+/**
+ * Runs the weapon sweeps of every swinging melee trace component once per frame. One pawn overlap
+ * over the bounds of a component's swept paths finds the capsules near that attacker, then each of its
+ * swings is tested against them as a capsule to capsule distance. Queries stay as small as one
+ * attacker's reach however far apart the attackers are, and no attacker pays a query per swing.
+ */
+UCLASS()
+class FRAME_API UMeleeTraceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Component is dropped again once it has no open swing
+	void AddSwingingComponent(UMeleeTraceComponent* Component);
+
+private:
+
+	TArray<TWeakObjectPtr<UMeleeTraceComponent>> SwingingComponents;
+};
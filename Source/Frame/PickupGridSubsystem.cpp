@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupGridSubsystem.h"
+#include "Components/SphereComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Item.h"
+
+namespace PickupGrid
+{
+	//Roughly twice the usual pickup radius so a query touches few cells
+	constexpr float CellSize{ 400.f };
+}
+
+UPickupGridSubsystem::UPickupGridSubsystem() :
+	Grid(PickupGrid::CellSize),
+	MaxPickupRadius(0.f)
+{
+}
+
+void UPickupGridSubsystem::UpdatePickup(AItem* Item)
+{
+	if (Item == nullptr) return;
+
+	MaxPickupRadius = FMath::Max(MaxPickupRadius, Item->GetPickupRadius());
+	Grid.Update(Item, Item->GetActorLocation());
+}
+
+void UPickupGridSubsystem::RemovePickup(AItem* Item)
+{
+	Grid.Remove(Item);
+}
+
+void UPickupGridSubsystem::QueryPickups(const FVector& Location, float ProbeRadius, TArray<AItem*>& OutItems) const
+{
+	TArray<AItem*> Candidates;
+	Grid.Query(Location, MaxPickupRadius + ProbeRadius, Candidates);
+
+	for (AItem* Item : Candidates)
+	{
+		if (!IsValid(Item)) continue;
+
+		const float PickupRadius{ Item->GetPickupRadius() + ProbeRadius };
+		if (FVector::DistSquared(Location, Item->GetActorLocation()) <= PickupRadius * PickupRadius)
+		{
+			OutItems.Add(Item);
+		}
+	}
+}
+
+namespace PickupGridBenchmark
+{
+	//Same radii as the item area sphere and the character capsule
+	constexpr float PickupRadius{ 150.f };
+	constexpr float ProbeRadius{ 34.f };
+	constexpr float PickupSpacing{ 200.f };
+	constexpr int32 NumSteps{ 600 };
+	//Far above the level so nothing else takes part in the overlaps
+	const FVector Origin{ 0.f, 0.f, 100000.f };
+
+	//Probe walks back and forth across the field of pickups
+	FVector GetProbeLocation(int32 Step, float FieldSize)
+	{
+		const float Alpha{ static_cast<float>(Step) / NumSteps };
+		return Origin + FVector(Alpha * FieldSize, FMath::Sin(Alpha * 4.f * PI) * 0.5f * FieldSize + 0.5f * FieldSize, 0.f);
+	}
+
+	FVector GetPickupLocation(int32 Index, int32 PerRow)
+	{
+		return Origin + FVector((Index % PerRow) * PickupSpacing, (Index / PerRow) * PickupSpacing, 0.f);
+	}
+
+	//Seconds spent moving an overlap-generating probe through NumPickups overlap spheres
+	double TimeOverlapEvents(UWorld* World, int32 NumPickups, int32& OutOverlaps)
+	{
+		const int32 PerRow{ FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumPickups))) };
+		const float FieldSize{ PerRow * PickupSpacing };
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		AActor* PickupActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Origin), SpawnParams);
+		AActor* ProbeActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Origin), SpawnParams);
+		if (PickupActor == nullptr || ProbeActor == nullptr) return 0.0;
+
+		for (int32 i = 0; i < NumPickups; i++)
+		{
+			USphereComponent* Sphere = NewObject<USphereComponent>(PickupActor);
+			Sphere->SetSphereRadius(PickupRadius);
+			Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+			Sphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+			Sphere->SetGenerateOverlapEvents(true);
+			Sphere->SetWorldLocation(GetPickupLocation(i, PerRow));
+			Sphere->RegisterComponent();
+		}
+
+		USphereComponent* Probe = NewObject<USphereComponent>(ProbeActor);
+		Probe->SetSphereRadius(ProbeRadius);
+		Probe->SetCollisionObjectType(ECollisionChannel::ECC_Pawn);
+		Probe->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Probe->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+		Probe->SetGenerateOverlapEvents(true);
+		Probe->SetWorldLocation(GetProbeLocation(0, FieldSize));
+		Probe->RegisterComponent();
+
+		OutOverlaps = 0;
+		const double StartTime{ FPlatformTime::Seconds() };
+		for (int32 Step = 0; Step < NumSteps; Step++)
+		{
+			Probe->SetWorldLocation(GetProbeLocation(Step, FieldSize));
+			OutOverlaps += Probe->GetOverlapInfos().Num();
+		}
+		const double Elapsed{ FPlatformTime::Seconds() - StartTime };
+
+		PickupActor->Destroy();
+		ProbeActor->Destroy();
+		return Elapsed;
+	}
+
+	//Seconds spent querying a grid of NumPickups along the same path
+	double TimeGridQueries(int32 NumPickups, int32& OutOverlaps)
+	{
+		const int32 PerRow{ FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumPickups))) };
+		const float FieldSize{ PerRow * PickupSpacing };
+
+		TSpatialHashGrid<int32> Grid(PickupGrid::CellSize);
+		for (int32 i = 0; i < NumPickups; i++)
+		{
+			Grid.Update(i, GetPickupLocation(i, PerRow));
+		}
+
+		TArray<int32> Results;
+		OutOverlaps = 0;
+		const double StartTime{ FPlatformTime::Seconds() };
+		for (int32 Step = 0; Step < NumSteps; Step++)
+		{
+			Results.Reset();
+			Grid.Query(GetProbeLocation(Step, FieldSize), PickupRadius + ProbeRadius, Results);
+			OutOverlaps += Results.Num();
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr) return;
+
+		TArray<int32> Counts{ 100, 1000, 10000 };
+		if (Args.Num() > 0)
+		{
+			Counts.Reset();
+			for (const FString& Arg : Args)
+			{
+				Counts.Add(FMath::Max(FCString::Atoi(*Arg), 1));
+			}
+		}
+
+		for (const int32 NumPickups : Counts)
+		{
+			int32 OverlapHits{ 0 };
+			int32 GridHits{ 0 };
+			const double OverlapSeconds{ TimeOverlapEvents(World, NumPickups, OverlapHits) };
+			const double GridSeconds{ TimeGridQueries(NumPickups, GridHits) };
+
+			UE_LOG(LogTemp, Display, TEXT("Pickups %6d: overlap events %8.3f ms (%d overlaps), grid queries %8.3f ms (%d hits), %d steps"),
+				NumPickups,
+				OverlapSeconds * 1000.0, OverlapHits,
+				GridSeconds * 1000.0, GridHits,
+				NumSteps);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkPickupQueriesCommand(
+	TEXT("Frame.BenchmarkPickupQueries"),
+	TEXT("Times a probe moving through pickups with overlap events against grid queries. Optional pickup counts, default 100 1000 10000."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&PickupGridBenchmark::Run));
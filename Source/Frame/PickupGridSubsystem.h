@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHashGrid.h"
+#include "PickupGridSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Uniform grid of every item lying in the world waiting to be picked up.
+ * Pickups no longer generate overlap events; characters query the grid around themselves
+ * instead, and items only touch the grid when they enter or leave the pickup state.
+ */
+UCLASS()
+class FRAME_API UPickupGridSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPickupGridSubsystem();
+
+	//Adds the item at its current location, or moves it if already added
+	void UpdatePickup(AItem* Item);
+	void RemovePickup(AItem* Item);
+
+	//Appends pickups whose pickup radius reaches within ProbeRadius of Location
+	void QueryPickups(const FVector& Location, float ProbeRadius, TArray<AItem*>& OutItems) const;
+
+	FORCEINLINE int32 GetNumPickups() const { return Grid.Num(); }
+
+private:
+
+	TSpatialHashGrid<AItem*> Grid;
+
+	//Largest pickup radius added so far, bounds every query
+	float MaxPickupRadius;
+};
@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupPoolSubsystem.h"
+#include "Frame.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickup Pool Hits"), STAT_PickupPoolHits, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickup Pool Misses"), STAT_PickupPoolMisses, STATGROUP_Frame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Pickups"), STAT_PooledPickups, STATGROUP_Frame);
+
+namespace PickupPool
+{
+	//Spawns a new item with rarity and count set before OnConstruction reads them
+	AItem* CreateItem(UWorld* World, TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform, EItemRarity Rarity, int32 ItemCount)
+	{
+		AItem* Item = World->SpawnActorDeferred<AItem>(ItemClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Item)
+		{
+			Item->SetItemRarity(Rarity);
+			Item->SetItemCount(ItemCount);
+			Item->FinishSpawning(SpawnTransform);
+		}
+		return Item;
+	}
+}
+
+void UPickupPoolSubsystem::Deinitialize()
+{
+	//Actors go with the world, only drop the references
+	Buckets.Empty();
+
+	Super::Deinitialize();
+}
+
+AItem* UPickupPoolSubsystem::SpawnItem(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform, EItemState State)
+{
+	if (ItemClass == nullptr) return nullptr;
+
+	const AItem* ItemDefaults = ItemClass->GetDefaultObject<AItem>();
+	return SpawnItem(WorldContextObject, ItemClass, SpawnTransform, ItemDefaults->GetItemRarity(), ItemDefaults->GetItemCount(), State);
+}
+
+AItem* UPickupPoolSubsystem::SpawnItem(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform, EItemRarity Rarity, int32 ItemCount, EItemState State)
+{
+	if (ItemClass == nullptr || WorldContextObject == nullptr) return nullptr;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr) return nullptr;
+
+	UPickupPoolSubsystem* PickupPool = World->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPool)
+	{
+		return PickupPool->Acquire(ItemClass, SpawnTransform, Rarity, ItemCount, State);
+	}
+
+	AItem* Item = PickupPool::CreateItem(World, ItemClass, SpawnTransform, Rarity, ItemCount);
+	if (Item)
+	{
+		Item->SetItemState(State);
+	}
+	return Item;
+}
+
+void UPickupPoolSubsystem::ReleaseItem(const UObject* WorldContextObject, AItem* Item)
+{
+	if (!IsValid(Item)) return;
+
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UPickupPoolSubsystem* PickupPool = World ? World->GetSubsystem<UPickupPoolSubsystem>() : nullptr;
+	if (PickupPool)
+	{
+		PickupPool->Release(Item);
+		return;
+	}
+	Item->Destroy();
+}
+
+AItem* UPickupPoolSubsystem::Acquire(TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform, EItemRarity Rarity, int32 ItemCount, EItemState State)
+{
+	if (ItemClass == nullptr) return nullptr;
+
+	FPickupPoolBucket& Bucket = Buckets.FindOrAdd(ItemClass.Get());
+	while (Bucket.FreeItems.Num() > 0)
+	{
+		AItem* Item = Bucket.FreeItems.Pop(false);
+		if (!IsValid(Item)) continue;
+
+		PoolHits++;
+		INC_DWORD_STAT(STAT_PickupPoolHits);
+		DEC_DWORD_STAT(STAT_PooledPickups);
+
+		Item->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+		Item->SetActorHiddenInGame(false);
+		Item->ResetPooledItem(Rarity, ItemCount, State);
+		return Item;
+	}
+
+	PoolMisses++;
+	INC_DWORD_STAT(STAT_PickupPoolMisses);
+
+	AItem* Item = PickupPool::CreateItem(GetWorld(), ItemClass, SpawnTransform, Rarity, ItemCount);
+	if (Item)
+	{
+		Item->SetItemState(State);
+	}
+	return Item;
+}
+
+void UPickupPoolSubsystem::Release(AItem* Item)
+{
+	if (!IsValid(Item)) return;
+
+	FPickupPoolBucket& Bucket = Buckets.FindOrAdd(Item->GetClass());
+	if (Bucket.FreeItems.Num() >= MaxFreePerClass)
+	{
+		Item->Destroy();
+		return;
+	}
+
+	//Picked up state hides the meshes, turns off collision and leaves the pickup grid
+	Item->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	Item->SetItemState(EItemState::EIS_PickedUp);
+	Item->SetActorHiddenInGame(true);
+	Item->GetWorldTimerManager().ClearAllTimersForObject(Item);
+
+	Bucket.FreeItems.Add(Item);
+	INC_DWORD_STAT(STAT_PooledPickups);
+}
+
+void UPickupPoolSubsystem::Prewarm(TSubclassOf<AItem> ItemClass, int32 Count)
+{
+	if (ItemClass == nullptr) return;
+
+	const AItem* ItemDefaults = ItemClass->GetDefaultObject<AItem>();
+	const int32 NumFree{ Buckets.FindOrAdd(ItemClass.Get()).FreeItems.Num() };
+	const int32 NumToCreate{ FMath::Min(Count, MaxFreePerClass) - NumFree };
+	for (int32 i = 0; i < NumToCreate; i++)
+	{
+		AItem* Item = PickupPool::CreateItem(GetWorld(), ItemClass, FTransform::Identity, ItemDefaults->GetItemRarity(), ItemDefaults->GetItemCount());
+		Release(Item);
+	}
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Item.h"
+#include "PickupPoolSubsystem.generated.h"
+
+//Deactivated items of one class
+USTRUCT()
+struct FPickupPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AItem*> FreeItems;
+};
+
+/**
+ * Recycles ammo and weapon pickups. Collected items are hidden and parked instead of destroyed,
+ * and spawning an item of the same class reactivates one with new rarity, count and transform
+ * through SetItemState, so loot drops do not pay for building components or feed the GC.
+ */
+UCLASS()
+class FRAME_API UPickupPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	//Spawns through the world's pickup pool, or a new actor if there is none. Rarity and count come from the class defaults
+	static AItem* SpawnItem(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform, EItemState State = EItemState::EIS_PickUp);
+	static AItem* SpawnItem(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform, EItemRarity Rarity, int32 ItemCount, EItemState State = EItemState::EIS_PickUp);
+
+	template<typename T>
+	static T* SpawnItem(const UObject* WorldContextObject, TSubclassOf<T> ItemClass, const FTransform& SpawnTransform, EItemState State = EItemState::EIS_PickUp)
+	{
+		return Cast<T>(SpawnItem(WorldContextObject, TSubclassOf<AItem>(ItemClass), SpawnTransform, State));
+	}
+
+	//Returns the item to the world's pickup pool, or destroys it if there is none
+	static void ReleaseItem(const UObject* WorldContextObject, AItem* Item);
+
+	AItem* Acquire(TSubclassOf<AItem> ItemClass, const FTransform& SpawnTransform, EItemRarity Rarity, int32 ItemCount, EItemState State);
+	void Release(AItem* Item);
+
+	//Makes sure at least Count deactivated items of the class are waiting
+	void Prewarm(TSubclassOf<AItem> ItemClass, int32 Count);
+
+	//Number of spawns served from a deactivated item
+	UFUNCTION(BlueprintPure, Category = Pickups)
+	int32 GetPoolHits() const { return PoolHits; }
+
+	//Number of spawns that had to create a new actor
+	UFUNCTION(BlueprintPure, Category = Pickups)
+	int32 GetPoolMisses() const { return PoolMisses; }
+
+private:
+
+	UPROPERTY()
+	TMap<UClass*, FPickupPoolBucket> Buckets;
+
+	//Deactivated items kept per class - extras are destroyed on release
+	static constexpr int32 MaxFreePerClass{ 64 };
+
+	int32 PoolHits = 0;
+	int32 PoolMisses = 0;
+};
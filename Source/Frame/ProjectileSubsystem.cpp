@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Sound/SoundCue.h"
+#include "Explosive.h"
+#include "FXPoolSubsystem.h"
+#include "HordeSubsystem.h"
+#include "InstancedVisuals.h"
+#include "Frame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Simulate Projectiles"), STAT_SimulateProjectiles, STATGROUP_Frame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles In Flight"), STAT_ProjectilesInFlight, STATGROUP_Frame);
+
+namespace
+{
+	//Impact found during integration, applied after every projectile has moved
+	struct FProjectileImpact
+	{
+		FVector Location;
+		AActor* Owner;
+		FProjectilePayload Payload;
+	};
+}
+
+void UProjectileSubsystem::Deinitialize()
+{
+	InstancedVisuals::DestroyActor(VisualsActor);
+	MeshComponents.Empty();
+
+	Positions.Empty();
+	Velocities.Empty();
+	GravityScales.Empty();
+	Lifetimes.Empty();
+	Owners.Empty();
+	Payloads.Empty();
+
+	Super::Deinitialize();
+}
+
+void UProjectileSubsystem::LaunchProjectile(AActor* Owner, AController* InstigatorController, const FVector& Location, const FVector& Direction, float Damage, const FProjectileSettings& Settings)
+{
+	Positions.Add(Location);
+	Velocities.Add(Direction.GetSafeNormal() * Settings.Speed);
+	GravityScales.Add(Settings.GravityScale);
+	Lifetimes.Add(Settings.Lifetime);
+	Owners.Add(Owner);
+
+	FProjectilePayload Payload;
+	Payload.InstigatorController = InstigatorController;
+	Payload.Damage = Damage;
+	Payload.ExplosionRadius = Settings.ExplosionRadius;
+	Payload.ExplosionParticles = Settings.ExplosionParticles;
+	Payload.ExplosionSound = Settings.ExplosionSound;
+	Payload.MeshIndex = GetMeshIndex(Settings.Mesh);
+	Payloads.Add(Payload);
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	if (Positions.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_SimulateProjectiles);
+	SET_DWORD_STAT(STAT_ProjectilesInFlight, Positions.Num());
+
+	UWorld* World = GetWorld();
+	const FVector Gravity{ 0.f, 0.f, World->GetGravityZ() };
+	const UHordeSubsystem* Horde = World->GetSubsystem<UHordeSubsystem>();
+
+	TArray<FProjectileImpact> Impacts;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileTrace));
+
+	//Walk backwards so removed projectiles swap in ones already moved this tick
+	for (int32 Index = Positions.Num() - 1; Index >= 0; Index--)
+	{
+		Lifetimes[Index] -= DeltaTime;
+		if (Lifetimes[Index] <= 0.f)
+		{
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		Velocities[Index] += Gravity * GravityScales[Index] * DeltaTime;
+		const FVector Start{ Positions[Index] };
+		const FVector End{ Start + Velocities[Index] * DeltaTime };
+
+		//Trace the segment covered this tick, ignoring whoever fired it
+		AActor* Owner = Owners[Index].Get();
+		QueryParams.ClearIgnoredActors();
+		if (Owner)
+		{
+			QueryParams.AddIgnoredActor(Owner);
+		}
+
+		FHitResult HitResult;
+		const bool bHit{ World->LineTraceSingleByChannel(HitResult, Start, End, ECollisionChannel::ECC_Visibility, QueryParams) };
+
+		//Horde entities are not in the physics scene, detonate on one in front of the blocking hit
+		FHordeEntityHit EntityHit;
+		if (Horde && Horde->TraceEntities(Start, bHit ? HitResult.ImpactPoint : End, EntityHit))
+		{
+			Impacts.Add({ EntityHit.Location, Owner, Payloads[Index] });
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		if (bHit)
+		{
+			Impacts.Add({ HitResult.ImpactPoint, Owner, Payloads[Index] });
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		Positions[Index] = End;
+	}
+
+	UpdateInstances();
+
+	for (const FProjectileImpact& Impact : Impacts)
+	{
+		if (Impact.Payload.ExplosionSound)
+		{
+			UGameplayStatics::PlaySoundAtLocation(World, Impact.Payload.ExplosionSound, Impact.Location);
+		}
+		if (Impact.Payload.ExplosionParticles)
+		{
+			UFXPoolSubsystem::SpawnEmitter(World, Impact.Payload.ExplosionParticles, Impact.Location);
+		}
+		AExplosive::ApplyExplosionDamage(World, Impact.Location, Impact.Payload.ExplosionRadius, Impact.Payload.Damage, Impact.Owner, Impact.Payload.InstigatorController);
+	}
+}
+
+void UProjectileSubsystem::RemoveProjectile(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	GravityScales.RemoveAtSwap(Index, 1, false);
+	Lifetimes.RemoveAtSwap(Index, 1, false);
+	Owners.RemoveAtSwap(Index, 1, false);
+	Payloads.RemoveAtSwap(Index, 1, false);
+}
+
+int32 UProjectileSubsystem::GetMeshIndex(UStaticMesh* Mesh)
+{
+	if (Mesh == nullptr) return INDEX_NONE;
+
+	for (int32 MeshIndex = 0; MeshIndex < MeshComponents.Num(); MeshIndex++)
+	{
+		if (MeshComponents[MeshIndex]->GetStaticMesh() == Mesh) return MeshIndex;
+	}
+
+	UInstancedStaticMeshComponent* MeshComponent = InstancedVisuals::AddMeshComponent(GetWorld(), VisualsActor, Mesh);
+
+	return MeshComponents.Add(MeshComponent);
+}
+
+void UProjectileSubsystem::UpdateInstances()
+{
+	if (MeshComponents.Num() == 0) return;
+
+	TArray<TArray<FTransform>> MeshTransforms;
+	MeshTransforms.SetNum(MeshComponents.Num());
+	for (int32 Index = 0; Index < Positions.Num(); Index++)
+	{
+		const int32 MeshIndex = Payloads[Index].MeshIndex;
+		if (MeshIndex != INDEX_NONE)
+		{
+			MeshTransforms[MeshIndex].Add(FTransform(Velocities[Index].Rotation(), Positions[Index]));
+		}
+	}
+
+	for (int32 MeshIndex = 0; MeshIndex < MeshComponents.Num(); MeshIndex++)
+	{
+		UInstancedStaticMeshComponent* MeshComponent = MeshComponents[MeshIndex];
+		const TArray<FTransform>& Transforms = MeshTransforms[MeshIndex];
+
+		//Match instance count to projectiles, removing from the end so no indices shift
+		for (int32 InstanceIndex = MeshComponent->GetInstanceCount(); InstanceIndex < Transforms.Num(); InstanceIndex++)
+		{
+			MeshComponent->AddInstance(Transforms[InstanceIndex]);
+		}
+		for (int32 InstanceIndex = MeshComponent->GetInstanceCount() - 1; InstanceIndex >= Transforms.Num(); InstanceIndex--)
+		{
+			MeshComponent->RemoveInstance(InstanceIndex);
+		}
+
+		if (Transforms.Num() > 0)
+		{
+			MeshComponent->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+		}
+	}
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
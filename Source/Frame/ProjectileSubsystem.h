@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectileSubsystem.generated.h"
+
+class UStaticMesh;
+class UParticleSystem;
+class USoundCue;
+class UInstancedStaticMeshComponent;
+
+//Flight and explosion properties of a projectile weapon, read from the weapon data table
+USTRUCT(BlueprintType)
+struct FProjectileSettings
+{
+	GENERATED_BODY()
+
+	//Launch speed along the aim direction
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Speed = 3'000.f;
+
+	//Multiplier on world gravity, 0 flies straight
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float GravityScale = 0.f;
+
+	//Seconds before a projectile that hit nothing is removed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Lifetime = 5.f;
+
+	//Radius characters are damaged in on impact
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ExplosionRadius = 300.f;
+
+	//Mesh drawn as an instance for every projectile in flight
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UStaticMesh* Mesh = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UParticleSystem* ExplosionParticles = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	USoundCue* ExplosionSound = nullptr;
+};
+
+//Per projectile data only needed on impact
+USTRUCT()
+struct FProjectilePayload
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	AController* InstigatorController = nullptr;
+
+	UPROPERTY()
+	float Damage = 0.f;
+
+	UPROPERTY()
+	float ExplosionRadius = 0.f;
+
+	UPROPERTY()
+	UParticleSystem* ExplosionParticles = nullptr;
+
+	UPROPERTY()
+	USoundCue* ExplosionSound = nullptr;
+
+	//Index into MeshComponents, INDEX_NONE for no visual
+	int32 MeshIndex = INDEX_NONE;
+};
+
+/**
+ * Simulates every projectile in the world without an actor per projectile.
+ * Flight state is kept as parallel arrays and advanced in a single pass per tick,
+ * with one segment trace per projectile and one instanced mesh per projectile mesh.
+ */
+UCLASS()
+class FRAME_API UProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Adds a projectile travelling from Location along Direction
+	void LaunchProjectile(AActor* Owner, AController* InstigatorController, const FVector& Location, const FVector& Direction, float Damage, const FProjectileSettings& Settings);
+
+	FORCEINLINE int32 GetNumProjectiles() const { return Positions.Num(); }
+
+private:
+
+	void RemoveProjectile(int32 Index);
+
+	//Finds or creates the instanced mesh component drawing Mesh
+	int32 GetMeshIndex(UStaticMesh* Mesh);
+
+	//Writes this tick's positions into the instanced meshes
+	void UpdateInstances();
+
+	//Hot data, advanced every tick
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityScales;
+	TArray<float> Lifetimes;
+	TArray<TWeakObjectPtr<AActor>> Owners;
+
+	//Cold data, read on impact
+	UPROPERTY()
+	TArray<FProjectilePayload> Payloads;
+
+	//Actor holding the instanced mesh components
+	UPROPERTY()
+	AActor* VisualsActor = nullptr;
+
+	UPROPERTY()
+	TArray<UInstancedStaticMeshComponent*> MeshComponents;
+};
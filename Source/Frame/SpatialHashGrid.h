@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform grid of elements hashed by the cell their location falls in.
+ * Elements are only re-bucketed when they cross into another cell, and a radius query
+ * visits just the cells overlapping the query's bounds.
+ */
+template<typename ElementType>
+class TSpatialHashGrid
+{
+public:
+
+	explicit TSpatialHashGrid(float InCellSize = 500.f)
+		: CellSize(FMath::Max(InCellSize, 1.f))
+	{
+	}
+
+	//Adds the element or moves it to a new location
+	void Update(ElementType Element, const FVector& Location)
+	{
+		const FIntVector NewCell{ GetCell(Location) };
+		FIntVector* CurrentCell = ElementCells.Find(Element);
+		if (CurrentCell)
+		{
+			if (*CurrentCell == NewCell)
+			{
+				//Same cell, only the stored location changes
+				for (FEntry& Entry : Cells.FindChecked(NewCell))
+				{
+					if (Entry.Element == Element)
+					{
+						Entry.Location = Location;
+						break;
+					}
+				}
+				return;
+			}
+			RemoveFromCell(Element, *CurrentCell);
+			*CurrentCell = NewCell;
+		}
+		else
+		{
+			ElementCells.Add(Element, NewCell);
+		}
+		Cells.FindOrAdd(NewCell).Add({ Element, Location });
+	}
+
+	void Remove(ElementType Element)
+	{
+		FIntVector Cell;
+		if (ElementCells.RemoveAndCopyValue(Element, Cell))
+		{
+			RemoveFromCell(Element, Cell);
+		}
+	}
+
+	//Appends every element within Radius of Center
+	void Query(const FVector& Center, float Radius, TArray<ElementType>& OutElements) const
+	{
+		const FIntVector MinCell{ GetCell(Center - FVector(Radius)) };
+		const FIntVector MaxCell{ GetCell(Center + FVector(Radius)) };
+		const float RadiusSquared{ Radius * Radius };
+
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					const TArray<FEntry>* Entries = Cells.Find(FIntVector(X, Y, Z));
+					if (Entries == nullptr) continue;
+
+					for (const FEntry& Entry : *Entries)
+					{
+						if (FVector::DistSquared(Center, Entry.Location) <= RadiusSquared)
+						{
+							OutElements.Add(Entry.Element);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	bool Contains(ElementType Element) const { return ElementCells.Contains(Element); }
+
+	int32 Num() const { return ElementCells.Num(); }
+
+	float GetCellSize() const { return CellSize; }
+
+	FIntVector GetCell(const FVector& Location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / CellSize),
+			FMath::FloorToInt(Location.Y / CellSize),
+			FMath::FloorToInt(Location.Z / CellSize));
+	}
+
+	void Reset()
+	{
+		Cells.Reset();
+		ElementCells.Reset();
+	}
+
+private:
+
+	struct FEntry
+	{
+		ElementType Element;
+		FVector Location;
+	};
+
+	void RemoveFromCell(ElementType Element, const FIntVector& Cell)
+	{
+		TArray<FEntry>* Entries = Cells.Find(Cell);
+		if (Entries == nullptr) return;
+
+		const int32 EntryIndex = Entries->IndexOfByPredicate([Element](const FEntry& Entry) { return Entry.Element == Element; });
+		if (EntryIndex != INDEX_NONE)
+		{
+			Entries->RemoveAtSwap(EntryIndex, 1, false);
+		}
+		if (Entries->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+
+	float CellSize;
+
+	TMap<FIntVector, TArray<FEntry>> Cells;
+
+	//Cell each element is currently stored in
+	TMap<ElementType, FIntVector> ElementCells;
+};
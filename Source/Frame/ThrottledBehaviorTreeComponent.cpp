@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ThrottledBehaviorTreeComponent.h"
+
+void UThrottledBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	//Super has just scheduled its next tick
+	ClampTickInterval();
+}
+
+void UThrottledBehaviorTreeComponent::SetMinTickInterval(float Interval)
+{
+	MinTickInterval = FMath::Max(Interval, 0.f);
+	ClampTickInterval();
+}
+
+void UThrottledBehaviorTreeComponent::ClampTickInterval()
+{
+	//A tree waiting on nothing has switched its tick off, leave it off
+	if (MinTickInterval > 0.f && IsComponentTickEnabled() && GetComponentTickInterval() < MinTickInterval)
+	{
+		SetComponentTickInterval(MinTickInterval);
+	}
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "ThrottledBehaviorTreeComponent.generated.h"
+
+/**
+ * Behavior tree component that never ticks more often than a minimum interval. The base component
+ * reschedules its own tick interval after every tick from what its tasks and services need next,
+ * so an interval set from outside only lasts one tick; this clamps the rescheduled one instead.
+ * Flow updates requested between ticks still run on the next frame.
+ */
+UCLASS()
+class FRAME_API UThrottledBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//Seconds between ticks at the least, 0 lets the tree tick as often as it asks to
+	void SetMinTickInterval(float Interval);
+
+	FORCEINLINE float GetMinTickInterval() const { return MinTickInterval; }
+
+private:
+
+	void ClampTickInterval();
+
+	float MinTickInterval = 0.f;
+};
@@ -3,6 +3,8 @@
 
 #include "Weapon.h"
 #include "Math/UnrealMathUtility.h"
+#include "FrameDataRegistry.h"
+#include "CurveBakerySubsystem.h"
 
 
 AWeapon::AWeapon() :
@@ -17,6 +19,7 @@ AWeapon::AWeapon() :
     ClipBoneName(TEXT("smg_clip")),
     SlideDisplacement(0.f),
     SlideDisplacementTime(0.2f),
+    SlideStartTime(0.f),
     bMovingSlide(false),
     MaxSlideDisplacement(4.f),
     MaxRecoilRotation(20.f),
@@ -60,6 +63,7 @@ void AWeapon::ThrowWeapon()
     GetWorldTimerManager().SetTimer(ThrowWeaponTimer, this, &AWeapon::StopFalling, ThrowWeaponTime);
 
     EnableGlowMaterial();
+    UpdateTickState();
 }
 
 
@@ -67,74 +71,106 @@ void AWeapon::StopFalling()
 {
     bFalling = false;
     SetItemState(EItemState::EIS_PickUp);
-    StartPulseTimer();
+    StartPulse();
 }
 
 void AWeapon::OnConstruction(const FTransform& Transform)
 {
     Super::OnConstruction(Transform);
-    const FString WeaponTablePath{TEXT("DataTable'/Game/_Game/Data_Tables/WeaponDataTable.WeaponDataTable'")};
-    UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
+    ApplyWeaponData();
+    InitializePulseMaterial();
+}
+
+void AWeapon::ApplyWeaponData()
+{
+    //Row for this weapon type, resolved once by the data registry
+    const FWeaponDataTable* WeaponDataRow = UFrameDataRegistry::GetDataTables(this).GetWeaponData(WeaponType);
+    if (WeaponDataRow)
+    {
+        AmmoType = WeaponDataRow->AmmoType;
+        Ammo = WeaponDataRow->WeaponAmmo;
+        MagazineCapacity = WeaponDataRow->MagazineCapacity;
+        SetPickUpSound(WeaponDataRow->PickupSound);
+        SetEquipSound(WeaponDataRow->EquipSound);
+        GetItemMesh()->SetSkeletalMesh(WeaponDataRow->ItemMesh);
+        SetItemName(WeaponDataRow->ItemName);
+        SetIconItem(WeaponDataRow->InventoryIcon);
+        SetAmmoIcon(WeaponDataRow->AmmoIcon);
+
+        SetMaterialInstance(WeaponDataRow->MaterialInstance);
+        PreviousMaterialIndex = GetMaterialIndex();
+        GetItemMesh()->SetMaterial(PreviousMaterialIndex, nullptr);
+        SetMaterialIndex(WeaponDataRow->MaterialIndex);
+        SetClipBoneName(WeaponDataRow->ClipBoneName);
+        SetReloadMontageSection(WeaponDataRow->ReloadMontageSection);
+        GetItemMesh()->SetAnimInstanceClass(WeaponDataRow->AnimBP);
+        CrosshairsMiddle = WeaponDataRow->CrosshairsMiddle;
+        CrosshairsLeft = WeaponDataRow->CrosshairsLeft;
+        CrosshairsRight = WeaponDataRow->CrosshairsRight;
+        CrosshairsTop = WeaponDataRow->CrosshairsTop;
+        CrosshairsBottom = WeaponDataRow->CrosshairsBottom;
+        AutoFireRate = WeaponDataRow->AutoFireRate;
+        MuzzleFlash = WeaponDataRow->MuzzleFlash;
+        FireSound = WeaponDataRow->FireSound;
+        BoneToHide = WeaponDataRow->BoneToHide;
+        GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
+        bAutomatic = WeaponDataRow->bAutomatic;
+        Damage = WeaponDataRow->Damage;
+        HeadshotDamage = WeaponDataRow->HeadshotDamage;
+        ProjectileSettings = WeaponDataRow->Projectile;
+    }
+}
+
+FInventoryRecord AWeapon::MakeInventoryRecord() const
+{
+    FInventoryRecord Record;
+    Record.ItemClass = GetClass();
+    Record.WeaponType = WeaponType;
+    Record.Rarity = GetItemRarity();
+    Record.Ammo = Ammo;
+    Record.ItemCount = GetItemCount();
+    Record.SlotIndex = GetSlotIndex();
+    Record.IconItem = GetIconItem();
+    Record.AmmoItem = GetAmmoIcon();
+    Record.IconBackground = GetIconBackground();
+    return Record;
+}
+
+void AWeapon::ApplyInventoryRecord(const FInventoryRecord& Record)
+{
+    //Pooled actor of the same class may be set up for another weapon type
+    ChangeWeaponType(Record.WeaponType);
+    Ammo = Record.Ammo;
+    SetSlotIndex(Record.SlotIndex);
+}
+
+void AWeapon::ChangeWeaponType(EWeaponType NewWeaponType)
+{
+    if (NewWeaponType == WeaponType) return;
 
-    if (WeaponTableObject)
+    GetItemMesh()->UnHideBoneByName(BoneToHide);
+    WeaponType = NewWeaponType;
+    ApplyWeaponData();
+    InitializePulseMaterial();
+}
+
+void AWeapon::ResetPooledItem(EItemRarity Rarity, int32 Count, EItemState State)
+{
+    bFalling = false;
+    bMovingSlide = false;
+    SlideDisplacement = 0.f;
+    RecoilRotation = 0.f;
+
+    //Pool buckets by class only, undo any weapon type a rehydrated record gave this actor
+    ChangeWeaponType(GetClass()->GetDefaultObject<AWeapon>()->WeaponType);
+
+    const FWeaponDataTable* WeaponDataRow = UFrameDataRegistry::GetDataTables(this).GetWeaponData(WeaponType);
+    if (WeaponDataRow)
     {
-        FWeaponDataTable* WeaponDataRow = nullptr;
-        switch (WeaponType)
-        {
-            case EWeaponType::EWT_SubmachineGun:
-                WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("SubmachineGun"), TEXT(""));
-                break;
-            case EWeaponType::EWT_AssaultRifle:
-                WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("AssaultRifle"), TEXT(""));
-                break;
-            case EWeaponType::EWT_Pistol:
-                WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("Pistol"), TEXT(""));
-                break;
-        }
-
-        if (WeaponDataRow)
-        {
-            AmmoType = WeaponDataRow->AmmoType;
-            Ammo = WeaponDataRow->WeaponAmmo;
-            MagazineCapacity = WeaponDataRow->MagazineCapacity;
-            SetPickUpSound(WeaponDataRow->PickupSound);
-            SetEquipSound(WeaponDataRow->EquipSound);
-            GetItemMesh()->SetSkeletalMesh(WeaponDataRow->ItemMesh);
-            SetItemName(WeaponDataRow->ItemName);
-            SetIconItem(WeaponDataRow->InventoryIcon);
-            SetAmmoIcon(WeaponDataRow->AmmoIcon);
-
-            SetMaterialInstance(WeaponDataRow->MaterialInstance);
-            PreviousMaterialIndex = GetMaterialIndex();
-            GetItemMesh()->SetMaterial(PreviousMaterialIndex, nullptr);
-            SetMaterialIndex(WeaponDataRow->MaterialIndex);
-            SetClipBoneName(WeaponDataRow->ClipBoneName);
-            SetReloadMontageSection(WeaponDataRow->ReloadMontageSection);
-            GetItemMesh()->SetAnimInstanceClass(WeaponDataRow->AnimBP);
-            CrosshairsMiddle = WeaponDataRow->CrosshairsMiddle;
-            CrosshairsLeft = WeaponDataRow->CrosshairsLeft;
-            CrosshairsRight = WeaponDataRow->CrosshairsRight;
-            CrosshairsTop = WeaponDataRow->CrosshairsTop;
-            CrosshairsBottom = WeaponDataRow->CrosshairsBottom;
-            AutoFireRate = WeaponDataRow->AutoFireRate;
-            MuzzleFlash = WeaponDataRow->MuzzleFlash;
-            FireSound = WeaponDataRow->FireSound;
-            BoneToHide = WeaponDataRow->BoneToHide;
-            GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
-            bAutomatic = WeaponDataRow->bAutomatic;
-            Damage = WeaponDataRow->Damage;
-            HeadshotDamage = WeaponDataRow->HeadshotDamage;
-
-        }
-
-        if (GetMaterialInstance())
-	    {
-            SetDynamicMaterialInstance(UMaterialInstanceDynamic::Create(GetMaterialInstance(), this));
-            GetDynamicMaterialInstance()->SetVectorParameterValue(TEXT("FresnelColor"), GetGlowColor());
-            GetItemMesh()->SetMaterial(GetMaterialIndex(), GetDynamicMaterialInstance());
-            EnableGlowMaterial();
-	    }
-    } 
+        Ammo = WeaponDataRow->WeaponAmmo;
+    }
+
+    Super::ResetPooledItem(Rarity, Count, State);
 }
 
 void AWeapon::BeginPlay()
@@ -149,14 +185,15 @@ void AWeapon::BeginPlay()
 void AWeapon::FinishMovingSlide()
 {
     bMovingSlide = false;
+    UpdateTickState();
 }
 
 void AWeapon::UpdateSlideDisplacement()
 {
-    if (SlideDisplacementCurve && bMovingSlide)
+    if (BakedSlideDisplacementCurve && bMovingSlide)
     {
-        const float ElapsedTime{ GetWorldTimerManager().GetTimerElapsed(SlideTimer) };
-        const float CurveValue{ SlideDisplacementCurve->GetFloatValue(ElapsedTime) };
+        const float ElapsedTime{ GetWorld()->GetTimeSeconds() - SlideStartTime };
+        const float CurveValue{ BakedSlideDisplacementCurve->Eval(ElapsedTime) };
         SlideDisplacement = CurveValue * MaxSlideDisplacement;
         RecoilRotation = CurveValue * MaxRecoilRotation;
     }
@@ -167,6 +204,19 @@ void AWeapon::StartSlideTimer()
 {
     bMovingSlide = true;
     GetWorldTimerManager().SetTimer(SlideTimer, this, &AWeapon::FinishMovingSlide, SlideDisplacementTime);
+    SlideStartTime = GetWorld()->GetTimeSeconds();
+    UpdateTickState();
+}
+
+void AWeapon::BakeCurves()
+{
+    Super::BakeCurves();
+    BakedSlideDisplacementCurve = UCurveBakerySubsystem::GetBakedCurve(this, SlideDisplacementCurve);
+}
+
+bool AWeapon::ShouldTick() const
+{
+    return Super::ShouldTick() || (GetItemState() == EItemState::EIS_Falling && bFalling) || bMovingSlide;
 }
 
 void AWeapon::DecrementAmmo()
@@ -7,6 +7,7 @@
 #include "AmmoType.h"
 #include "Engine/DataTable.h"
 #include "WeaponType.h"
+#include "ProjectileSubsystem.h"
 #include "Weapon.generated.h"
 
 
@@ -94,9 +95,51 @@ struct FWeaponDataTable : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float HeadshotDamage;
 
+	//Only used by weapons firing rocket ammo
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FProjectileSettings Projectile;
+
 };
 
 
+//Weapon held in the inventory without an actor, rehydrated when equipped or dropped
+USTRUCT(BlueprintType)
+struct FInventoryRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	TSubclassOf<AItem> ItemClass;
+
+	UPROPERTY(BlueprintReadOnly)
+	EWeaponType WeaponType = EWeaponType::EWT_SubmachineGun;
+
+	UPROPERTY(BlueprintReadOnly)
+	EItemRarity Rarity = EItemRarity::EIR_Common;
+
+	//Rounds in the magazine
+	UPROPERTY(BlueprintReadOnly)
+	int32 Ammo = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ItemCount = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 SlotIndex = 0;
+
+	//Inventory bar icons, same names as on AItem
+	UPROPERTY(BlueprintReadOnly)
+	UTexture2D* IconItem = nullptr;
+
+	UPROPERTY(BlueprintReadOnly)
+	UTexture2D* AmmoItem = nullptr;
+
+	UPROPERTY(BlueprintReadOnly)
+	UTexture2D* IconBackground = nullptr;
+
+	bool IsValid() const { return ItemClass != nullptr; }
+};
+
 UCLASS()
 class FRAME_API AWeapon : public AItem
 {
@@ -113,11 +156,22 @@ protected:
 
 	virtual void OnConstruction(const FTransform& Transform) override;
 
+	//Reads everything for WeaponType from the weapon data table
+	void ApplyWeaponData();
+
+	//Turns a pooled actor of this class into another weapon type, bone, data and glow included
+	void ChangeWeaponType(EWeaponType NewWeaponType);
+
 	virtual void BeginPlay() override;
 
 	void FinishMovingSlide();
 	void UpdateSlideDisplacement();
 
+	//Also ticks while falling upright or moving the pistol slide
+	virtual bool ShouldTick() const override;
+
+	virtual void BakeCurves() override;
+
 private:
 
 	FTimerHandle ThrowWeaponTimer;
@@ -197,9 +251,15 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pistol, meta = (AllowPrivateAccess = "true"))
 	UCurveFloat* SlideDisplacementCurve;
 
+	//Baked table of SlideDisplacementCurve
+	TSharedPtr<const FBakedFloatCurve> BakedSlideDisplacementCurve;
+
 	//Timer handle for updating SlideDisplacement
 	FTimerHandle SlideTimer;
 
+	//World time the slide started moving
+	float SlideStartTime;
+
 	//Time for displacing slide during pistol fire
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pistol, meta = (AllowPrivateAccess = "true"))
 	float SlideDisplacementTime;
@@ -232,6 +292,10 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	float HeadshotDamage;
 
+	//Projectile fired instead of a hitscan bullet for rocket ammo
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	FProjectileSettings ProjectileSettings;
+
 public:
 	
 	//Adds impulse to weapon drop
@@ -243,6 +307,14 @@ public:
 	//Called from character class when weapon fired
 	void DecrementAmmo();
 
+	//Refills the magazine and clears throw and slide state
+	virtual void ResetPooledItem(EItemRarity Rarity, int32 Count, EItemState State) override;
+
+	//Dehydrates the weapon into a record for the inventory
+	FInventoryRecord MakeInventoryRecord() const;
+	//Restores type, magazine and slot from a record, called on the actor spawned to rehydrate it
+	void ApplyInventoryRecord(const FInventoryRecord& Record);
+
 	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
 
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
@@ -260,6 +332,8 @@ public:
 	FORCEINLINE bool GetAutomatic() const { return bAutomatic; }
 	FORCEINLINE float GetDamage() const { return Damage; }
 	FORCEINLINE float GetHeadshotDamage() const { return HeadshotDamage; }
+	FORCEINLINE const FProjectileSettings& GetProjectileSettings() const { return ProjectileSettings; }
+	FORCEINLINE bool FiresProjectiles() const { return AmmoType == EAmmoType::EAT_Rocket; }
 
 	void StartSlideTimer();
 
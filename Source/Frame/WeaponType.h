@@ -7,6 +7,7 @@ enum class EWeaponType : uint8
 	EWT_SubmachineGun UMETA(DisplayName = "SubmachineGun"),
 	EWT_AssaultRifle UMETA(DisplayName = "AssaultRifle"),
 	EWT_Pistol UMETA(DisplayName = "Pistol"),
+	EWT_RocketLauncher UMETA(DisplayName = "RocketLauncher"),
 	
 
 	EWT_MAX UMETA(DisplayName = "DefaultMAX"),